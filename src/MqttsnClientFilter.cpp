@@ -17,17 +17,24 @@
 
 #include "MqttsnClientFilter.h"
 
+#include "MqttsnClientFilterSubsIo.h"
+
 #include <QtCore/QByteArray>
 #include <QtCore/QDateTime>
 #include <QtCore/QList>
+#include <QtCore/QMetaMethod>
 #include <QtCore/QVariant>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <string_view>
 
 namespace cc_plugin_mqttsn_client_filter
 {
@@ -35,6 +42,28 @@ namespace cc_plugin_mqttsn_client_filter
 namespace 
 {
 
+const unsigned SpillReadAhead = 16U;
+const unsigned SpillMaxAttempts = 8U;
+const qint64 RttRetuneIntervalUs = 1000000;
+const std::size_t ShortTopicNameLen = 2U;
+const double MinShaperScale = 1.0 / 32;
+const double ShaperRecoverStep = 1.0 / 32;
+const std::size_t MaxTopicBuckets = 1024U;
+const std::uint8_t CompressMarker[] = {0xcc, 0x03};
+const std::size_t CompressMarkerLen = std::extent<decltype(CompressMarker)>::value;
+const std::size_t RxDupTableSize = 4096U;
+const std::uint64_t FnvOffsetBasis = 0xcbf29ce484222325ULL;
+const std::size_t MaxRxTopicStates = 4096U;
+const qint64 RxRateWindowUs = 1000000;
+const int TrieExcludeValue = -1;
+const std::size_t MaxPubRuleCache = 4096U;
+const std::size_t MaxRegisteredTopics = 1024U;
+const unsigned MinProbeInterval = 10U;
+const qint64 ProbeTimeoutIntervals = 4;
+const qint64 MinProbeTimeoutUs = 2000000;
+const std::size_t DataInfoPoolSize = 1024U;
+const std::size_t DataInfoPayloadCapacity = 256U;
+
 inline MqttsnClientFilter* asThis(void* data)
 {
     return reinterpret_cast<MqttsnClientFilter*>(data);
@@ -160,6 +189,54 @@ const QString& aliasSubscribesClearProp()
     return Str;    
 }
 
+const QString& subscribesImportProp()
+{
+    static const QString Str("mqttsn.subscribes_import");
+    return Str;
+}
+
+const QString& aliasSubscribesImportProp()
+{
+    static const QString Str("mqtt.subscribes_import");
+    return Str;
+}
+
+const QString& subscribesExportProp()
+{
+    static const QString Str("mqttsn.subscribes_export");
+    return Str;
+}
+
+const QString& aliasSubscribesExportProp()
+{
+    static const QString Str("mqtt.subscribes_export");
+    return Str;
+}
+
+const QString& priorityProp()
+{
+    static const QString Str("mqttsn.priority");
+    return Str;
+}
+
+const QString& expiryProp()
+{
+    static const QString Str("mqttsn.expiry");
+    return Str;
+}
+
+const QString& subIndexProp()
+{
+    static const QString Str("mqttsn.sub_index");
+    return Str;
+}
+
+const QString& subTopicProp()
+{
+    static const QString Str("mqttsn.sub_topic");
+    return Str;
+}
+
 const QString& topicSubProp()
 {
     static const QString Str("topic");
@@ -172,7 +249,31 @@ const QString& qosSubProp()
     return Str;
 }
 
-std::string getOutgoingTopic(const QVariantMap& props, const QString configVal)
+const QString& dataSubProp()
+{
+    static const QString Str("data");
+    return Str;
+}
+
+const QString& retainedSubProp()
+{
+    static const QString Str("retained");
+    return Str;
+}
+
+const QString& lastValuesQueryProp()
+{
+    static const QString Str("mqttsn.last_values_query");
+    return Str;
+}
+
+const QString& lastValuesProp()
+{
+    static const QString Str("mqttsn.last_values");
+    return Str;
+}
+
+std::string getOutgoingTopic(const QVariantMap& props, const std::string& configVal)
 {
     if (props.contains(topicProp())) {
         return props[topicProp()].value<QString>().toStdString();
@@ -182,7 +283,7 @@ std::string getOutgoingTopic(const QVariantMap& props, const QString configVal)
         return props[aliasTopicProp()].value<QString>().toStdString();
     }
 
-    return configVal.toStdString();
+    return configVal;
 }
 
 unsigned getOutgoingTopicId(const QVariantMap& props, unsigned configVal)
@@ -220,6 +321,100 @@ bool getOutgoingRetained(const QVariantMap& props)
     return false;
 }
 
+std::uint64_t fnv1aHash(const std::uint8_t* data, std::size_t len, std::uint64_t hash = FnvOffsetBasis)
+{
+    for (auto idx = 0U; idx < len; ++idx) {
+        hash ^= data[idx];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+qint64 monotonicUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The PUBLISH and SUBSCRIBE messages re-sent by the library have the DUP flag set
+bool isRetransmit(const unsigned char* buf, unsigned bufLen)
+{
+    static const unsigned char MsgType_Publish = 0x0c;
+    static const unsigned char MsgType_Subscribe = 0x12;
+    static const unsigned char DupFlag = 0x80;
+
+    unsigned typeIdx = 1U;
+    if ((0U < bufLen) && (buf[0] == 0x01)) {
+        // Long form of the length field
+        typeIdx = 3U;
+    }
+
+    if (bufLen <= (typeIdx + 1U)) {
+        return false;
+    }
+
+    auto msgType = buf[typeIdx];
+    return 
+        ((msgType == MsgType_Publish) || (msgType == MsgType_Subscribe)) && 
+        ((buf[typeIdx + 1U] & DupFlag) != 0U);
+}
+
+std::vector<std::string> splitTopicFilters(const QString& str)
+{
+    std::vector<std::string> result;
+    auto topics = str.split(',');
+    for (auto& t : topics) {
+        auto trimmed = t.trimmed();
+        if (!trimmed.isEmpty()) {
+            result.push_back(trimmed.toStdString());
+        }
+    }
+    return result;
+}
+
+bool topicMatches(std::string_view filter, std::string_view topic)
+{
+    std::size_t fPos = 0U;
+    std::size_t tPos = 0U;
+    while (true) {
+        auto fEnd = std::min(filter.find('/', fPos), filter.size());
+        auto fLen = fEnd - fPos;
+        if ((fLen == 1U) && (filter[fPos] == '#')) {
+            return true;
+        }
+
+        auto tEnd = std::min(topic.find('/', tPos), topic.size());
+        bool singleLevelWildcard = (fLen == 1U) && (filter[fPos] == '+');
+        if ((!singleLevelWildcard) && (filter.compare(fPos, fLen, topic, tPos, tEnd - tPos) != 0)) {
+            return false;
+        }
+
+        bool filterDone = (filter.size() <= fEnd);
+        bool topicDone = (topic.size() <= tEnd);
+        if (filterDone && topicDone) {
+            return true;
+        }
+
+        if (filterDone || topicDone) {
+            // "some/#" also matches "some"
+            return topicDone && (filter.compare(fEnd, std::string_view::npos, "/#") == 0);
+        }
+
+        fPos = fEnd + 1U;
+        tPos = tEnd + 1U;
+    }
+}
+
+bool topicMatchesAny(const std::vector<std::string>& filters, std::string_view topic)
+{
+    return 
+        std::any_of(
+            filters.begin(), filters.end(),
+            [topic](auto& f)
+            {
+                return topicMatches(f, topic);
+            });
+}
+
 const QString& errorCodeStr(CC_MqttsnErrorCode ec)
 {
     static const QString Map[] = {
@@ -316,13 +511,46 @@ const QString& disconnectReasonStr(CC_MqttsnGatewayDisconnectReason value)
     
 
 MqttsnClientFilter::MqttsnClientFilter() :
-    m_client(::cc_mqttsn_client_alloc())
+    m_client(::cc_mqttsn_client_alloc()),
+    m_dataInfoPool(DataInfoPoolSize, DataInfoPayloadCapacity),
+    m_rxDupTable(RxDupTableSize),
+    m_debugOut(&std::cout)
 {
     m_timer.setSingleShot(true);
     connect(
         &m_timer, &QTimer::timeout,
         this, &MqttsnClientFilter::doTick);
 
+    m_spillTimer.setSingleShot(true);
+    connect(
+        &m_spillTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doSpillReplay);
+
+    m_dispatchTimer.setSingleShot(true);
+    connect(
+        &m_dispatchTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doDispatch);
+
+    m_coalesceTimer.setSingleShot(true);
+    connect(
+        &m_coalesceTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doCoalesceFlush);
+
+    m_fragmentTimer.setSingleShot(true);
+    connect(
+        &m_fragmentTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doFragmentRelease);
+
+    connect(
+        &m_probeTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doProbe);
+
+    connect(
+        &m_rxFlushTimer, &QTimer::timeout,
+        this, &MqttsnClientFilter::doRxFlush);
+
+    m_lanes.resize(1U);
+
     ::cc_mqttsn_client_set_send_output_data_callback(m_client.get(), &MqttsnClientFilter::sendDataCb, this);
     ::cc_mqttsn_client_set_gw_disconnect_report_callback(m_client.get(), &MqttsnClientFilter::gwDisconnectedCb, this);
     ::cc_mqttsn_client_set_message_report_callback(m_client.get(), &MqttsnClientFilter::messageReceivedCb, this);
@@ -336,25 +564,213 @@ MqttsnClientFilter::MqttsnClientFilter() :
 
 MqttsnClientFilter::~MqttsnClientFilter() noexcept = default;
 
+MqttsnClientFilter::LaneStatsList MqttsnClientFilter::laneStats() const
+{
+    LaneStatsList result;
+    result.reserve(m_lanes.size());
+    for (auto& lane : m_lanes) {
+        result.push_back(lane.m_stats);
+        result.back().m_depth = lane.m_queue.size();
+    }
+    return result;
+}
+
+bool MqttsnClientFilter::importSubscribes(const QString& path)
+{
+    MqttsnClientFilterSubsIo::ImportResult result;
+    bool ok = MqttsnClientFilterSubsIo::importFile(path, m_config.m_subscribes, result);
+    if (!ok) {
+        reportError(tr("Failed to import MQTTSN subscribes from ") + path + ": " + result.m_error);
+    }
+    else if (0U < result.m_invalid) {
+        reportError(
+            tr("Skipped %1 invalid MQTTSN subscribes in ").arg(result.m_invalid) + path + 
+            tr(", first at ") + result.m_error);
+    }
+
+    if (1 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): imported subscribes: " << 
+            result.m_added << " added, " << result.m_updated << " updated, " << 
+            result.m_duplicates << " duplicates, " << result.m_invalid << " invalid" << std::endl;
+    }
+
+    if ((0U < result.m_added) || (0U < result.m_updated)) {
+        m_topicTrieDirty = true;
+        forceCleanSession();
+        emit sigConfigChanged();
+    }
+
+    return ok;
+}
+
+bool MqttsnClientFilter::exportSubscribes(const QString& path)
+{
+    QString error;
+    if (!MqttsnClientFilterSubsIo::exportFile(path, m_config.m_subscribes, error)) {
+        reportError(tr("Failed to export MQTTSN subscribes to ") + path + ": " + error);
+        return false;
+    }
+
+    return true;
+}
+
+bool MqttsnClientFilter::exportTopicStats(const QString& path)
+{
+    QString error;
+    if (!m_topicStats.exportCsv(path, error)) {
+        reportError(tr("Failed to export MQTTSN topic statistics to ") + path + ": " + error);
+        return false;
+    }
+
+    return true;
+}
+
+MqttsnClientFilter::DedupStatsList MqttsnClientFilter::dedupStats() const
+{
+    DedupStatsList result;
+    result.reserve(m_dedupEntries.size());
+    for (auto& e : m_dedupEntries) {
+        result.resize(result.size() + 1U);
+        auto& stats = result.back();
+        stats.m_topic = QString::fromStdString(e.first);
+        stats.m_sent = e.second.m_sent;
+        stats.m_suppressed = e.second.m_suppressed;
+    }
+    return result;
+}
+
+MqttsnClientFilter::RxLimitStatsList MqttsnClientFilter::rxLimitStats() const
+{
+    RxLimitStatsList result;
+    for (auto& s : m_rxTopicStates) {
+        if (s.second.m_rule < 0) {
+            continue;
+        }
+
+        result.resize(result.size() + 1U);
+        auto& stats = result.back();
+        stats.m_topic = QString::fromStdString(s.first);
+        stats.m_passed = s.second.m_passed;
+        stats.m_dropped = s.second.m_dropped;
+    }
+    return result;
+}
+
+MqttsnClientFilter::RttInfo MqttsnClientFilter::rttInfo() const
+{
+    RttInfo result;
+    result.m_srttMs = m_rtt.srtt();
+    result.m_rttVarMs = m_rtt.rttVar();
+    result.m_lastSampleMs = m_rtt.lastSample();
+    result.m_samples = m_rtt.samples();
+    result.m_retryPeriod = ::cc_mqttsn_client_get_default_retry_period(m_client.get());
+    return result;
+}
+
+MqttsnClientFilter::PerfSnapshot MqttsnClientFilter::perfSnapshot() const
+{
+    PerfSnapshot result;
+    result.m_timestampUs = monotonicUs();
+    result.m_connectionStatus = ::cc_mqttsn_client_get_connection_status(m_client.get());
+    result.m_socketConnected = m_socketConnected;
+    result.m_published = m_published;
+    result.m_received = m_received;
+    result.m_retransmits = m_retransmits;
+    result.m_timeouts = m_timeouts;
+    result.m_inFlight = m_publishOps.size() + m_subscribeOps.size();
+    result.m_pending = m_pendingData.size();
+    for (auto& lane : m_lanes) {
+        result.m_pending += lane.m_queue.size();
+    }
+    result.m_srttMs = m_rtt.srtt();
+    result.m_lastRttMs = m_rtt.lastSample();
+    auto poolStats = m_dataInfoPool.stats();
+    result.m_poolHits = poolStats.m_hits;
+    result.m_poolMisses = poolStats.m_misses;
+    return result;
+}
+
 bool MqttsnClientFilter::startImpl()
 {
-    auto ec = ::cc_mqttsn_client_set_default_retry_period(m_client.get(), m_config.m_retryPeriod);
+    auto retryPeriod = m_config.m_retryPeriod;
+    if (m_config.m_adaptiveRetry && m_rtt.hasEstimate()) {
+        retryPeriod = m_rtt.retryPeriod(m_config.m_minRetryPeriod, m_config.m_maxRetryPeriod);
+    }
+
+    auto ec = ::cc_mqttsn_client_set_default_retry_period(m_client.get(), retryPeriod);
     if (ec != CC_MqttsnErrorCode_Success) {
         reportError(tr("Failed to update MQTT-SN default retry period"));
         return false;
     }  
 
+    m_currRetryPeriod = retryPeriod;
+    m_rttTuneTsUs = 0;
+
     ec = ::cc_mqttsn_client_set_default_retry_count(m_client.get(), m_config.m_retryCount);
     if (ec != CC_MqttsnErrorCode_Success) {
         reportError(tr("Failed to update MQTT-SN default retry count"));
         return false;
     }      
 
+    loadSessionState();
+    applyLanesConfig();
+    m_coalesceFilters = splitTopicFilters(m_config.m_coalesceTopics);
+    m_coalescer.setLimits(m_config.m_coalesceWindow, m_config.m_coalesceMaxSize);
+    m_coalescer.setMergedProps(expiryProp(), priorityProp());
+    m_fragmenter.setReassemblyLimits(m_config.m_reassemblyMaxSize, m_config.m_reassemblyMaxTotal, m_config.m_reassemblyTimeout);
+    m_reassemblyFilters = splitTopicFilters(m_config.m_reassemblyTopics);
+    m_compressFilters = splitTopicFilters(m_config.m_compressTopics);
+    m_dedupFilters = splitTopicFilters(m_config.m_dedupTopics);
+    m_rxDedupFilters = splitTopicFilters(m_config.m_rxDedupTopics);
+    m_rxDupTable.setWindow(m_config.m_rxDedupWindow);
+    applyRxLimitsConfig();
+    applyPubRulesConfig();
+    m_topicTrieDirty = true;
+    m_lastValues.setLimits(m_config.m_lastValueCacheSize, m_config.m_lastValueMaxEntrySize);
+    m_topicStats.setMaxTopics(m_config.m_topicStatsLimit);
+
+    auto probeTopic = m_config.m_probeTopic.trimmed().toStdString();
+    if (probeTopic != m_probeTopic) {
+        m_probeTopic = std::move(probeTopic);
+        m_probe.reset();
+        m_probeTimer.stop();
+    }
+
+    if (m_spillLog.dir() != m_config.m_spillDir) {
+        m_spillLog.close();
+        m_spillInFlight = 0U;
+        m_spillRetries.clear();
+        m_spillRetriesInFlight = 0U;
+        if ((!m_config.m_spillDir.isEmpty()) && (!m_spillLog.open(m_config.m_spillDir))) {
+            reportError(tr("Failed to open MQTTSN spill directory: ") + m_config.m_spillDir);
+        }
+    }
+
+    if ((!m_capture.isOpen()) || (m_capture.path() != m_config.m_captureFile)) {
+        m_capture.close();
+        if ((!m_config.m_captureFile.isEmpty()) && (!m_capture.open(m_config.m_captureFile))) {
+            reportError(tr("Failed to open MQTTSN capture file: ") + m_config.m_captureFile);
+        }
+    }
+
     return true; 
 }
 
 void MqttsnClientFilter::stopImpl()
 {
+    m_probeTimer.stop();
+    m_rxFlushTimer.stop();
+
+    if (!m_coalescer.isEmpty()) {
+        // The open batches are published before the disconnect or kept pending for the next session
+        m_coalesceTimer.stop();
+        m_sendData.clear();
+        MqttsnClientFilterCoalescer::DataInfosList ready;
+        m_coalescer.takeAll(ready);
+        submitCoalescedInternal(ready);
+        reportCollectedSendData();
+    }
+
     if (::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) {
         return;
     }
@@ -369,12 +785,71 @@ void MqttsnClientFilter::stopImpl()
 QList<cc_tools_qt::DataInfoPtr> MqttsnClientFilter::recvDataImpl(cc_tools_qt::DataInfoPtr dataPtr)
 {
     m_recvData.clear();
+    m_recvProps = dataPtr->m_extraProperties;
     m_recvDataPtr = std::move(dataPtr);
-    ::cc_mqttsn_client_process_data(m_client.get(), m_recvDataPtr->m_data.data(), static_cast<unsigned>(m_recvDataPtr->m_data.size()), CC_MqttsnDataOrigin_ConnectedGw);
+    processRecvDataInternal();
+    flushLatestValuesInternal();
+    m_recvDataPtr.reset();
+    return std::move(m_recvData);
+}
+
+QList<cc_tools_qt::DataInfoPtr> MqttsnClientFilter::recvDataBatch(const QList<cc_tools_qt::DataInfoPtr>& batch)
+{
+    m_recvData.clear();
+    if (batch.isEmpty()) {
+        return m_recvData;
+    }
+
+    // Usually every buffer carries at least one message
+    m_recvData.reserve(batch.size());
+    m_recvProps = batch.front()->m_extraProperties;
+    for (auto& dataPtr : batch) {
+        m_recvDataPtr = dataPtr;
+        processRecvDataInternal();
+    }
+
+    // The rate limited topics are flushed once per batch
+    flushLatestValuesInternal();
     m_recvDataPtr.reset();
     return std::move(m_recvData);
 }
 
+void MqttsnClientFilter::processRecvDataInternal()
+{
+    assert(m_recvDataPtr);
+    if ((m_capture.isOpen()) && 
+        (!m_capture.append(MqttsnClientFilterCapture::Direction_In, m_recvDataPtr->m_data.data(), m_recvDataPtr->m_data.size()))) {
+        captureFailedInternal();
+    }
+
+    if (!m_config.m_streamFraming) {
+        processFrameInternal(m_recvDataPtr->m_data.data(), m_recvDataPtr->m_data.size());
+    }
+    else {
+        auto discarded = m_framer.discarded();
+        m_framer.feed(
+            m_recvDataPtr->m_data.data(), m_recvDataPtr->m_data.size(),
+            [this](const std::uint8_t* frame, std::size_t frameLen)
+            {
+                processFrameInternal(frame, frameLen);
+            });
+
+        if ((discarded != m_framer.discarded()) && (1 <= getDebugOutputLevel())) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): discarded " << (m_framer.discarded() - discarded) << 
+                " bytes not starting a valid frame" << std::endl;
+        }
+    }
+}
+
+void MqttsnClientFilter::processFrameInternal(const std::uint8_t* frame, std::size_t frameLen)
+{
+    // The QoS1 redelivery by the gateway has the DUP flag set, the received 
+    // message is reported by the library while the frame is being processed.
+    m_rxFrameDup = isRetransmit(frame, static_cast<unsigned>(frameLen));
+    ::cc_mqttsn_client_process_data(m_client.get(), frame, static_cast<unsigned>(frameLen), CC_MqttsnDataOrigin_ConnectedGw);
+    m_rxFrameDup = false;
+}
+
 QList<cc_tools_qt::DataInfoPtr> MqttsnClientFilter::sendDataImpl(cc_tools_qt::DataInfoPtr dataPtr)
 {
     m_sendData.clear();
@@ -384,60 +859,30 @@ QList<cc_tools_qt::DataInfoPtr> MqttsnClientFilter::sendDataImpl(cc_tools_qt::Da
         return m_sendData;
     }
 
-    if (::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) {
-        m_pendingData.push_back(std::move(dataPtr));
-        return m_sendData;
+    if ((m_capture.isOpen()) && (!m_capture.appendPublish(*dataPtr))) {
+        captureFailedInternal();
     }
 
+    // The topic is rendered once and pinned to the message for the queued stages
     auto& props = dataPtr->m_extraProperties;
-    std::string topic = getOutgoingTopic(props, QString());
-    auto topicId = getOutgoingTopicId(props, 0U);
-
-    if (topic.empty() && (topicId == 0U)) {
-        topic = getOutgoingTopic(props, m_config.m_pubTopic);
-        topicId = getOutgoingTopicId(props, m_config.m_pubTopicId);        
+    if (outgoingTopicInternal(props, m_sendTopic)) {
+        props[topicProp()] = QString::fromStdString(m_sendTopic);
     }
-    
-    auto qos = getOutgoingQos(props, m_config.m_pubQos);
-    props[qosProp()] = qos;
-
-    auto retained = getOutgoingRetained(props);
-    props[retainedProp()] = retained;
-
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish: " << topic << std::endl;
-    }    
 
-    auto config = CC_MqttsnPublishConfig();
-    ::cc_mqttsn_client_publish_init_config(&config);
-
-    if (!topic.empty()) {
-        config.m_topic = topic.c_str();
-        props[topicProp()] = QString::fromStdString(topic);
-    }
-    else if (topicId != 0U) {
-        config.m_topicId = static_cast<decltype(config.m_topicId)>(topicId);
-        props[topicIdProp()] = topicId;
+    if (!m_pubRules.empty()) {
+        applyPubRuleInternal(props, m_sendTopic);
     }
-    config.m_data = dataPtr->m_data.data();
-    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(dataPtr->m_data.size());
-    config.m_qos = static_cast<decltype(config.m_qos)>(qos);    
-    config.m_retain = retained;
-
-    m_sendDataPtr = std::move(dataPtr);
 
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): initiating publish" << std::endl;
-    }    
+    if ((!m_dedupFilters.empty()) && (suppressInternal(*dataPtr, m_sendTopic))) {
+        return m_sendData;
+    }
 
-    auto ec = ::cc_mqttsn_client_publish(m_client.get(), &config, &MqttsnClientFilter::publishCompleteCb, this);
-    if (ec != CC_MqttsnErrorCode_Success) {
-        reportError(tr("Failed to send MQTTSN publish with error: ") + errorCodeStr(ec));
-        m_sendDataPtr.reset();
-        return m_sendData;        
+    if (coalesceInternal(dataPtr, m_sendTopic)) {
+        return std::move(m_sendData);
     }
 
-    m_sendDataPtr.reset();
+    submitDataInternal(std::move(dataPtr), m_sendTopic);
+    dispatchLanes();
     return std::move(m_sendData);
 }
 
@@ -448,6 +893,9 @@ void MqttsnClientFilter::socketConnectionReportImpl(bool connected)
     // }
 
     m_socketConnected = connected;
+
+    // The partial frame of the previous connection must not be prepended to the new data
+    m_framer.reset();
     if (connected) {
         socketConnected();
         return;
@@ -564,6 +1012,7 @@ void MqttsnClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
                 if (iter != m_config.m_subscribes.end()) {
                     m_config.m_subscribes.erase(iter);
                     updated = true;
+                    m_topicTrieDirty = true;
                     forceCleanSession();                    
                 }
             }
@@ -587,6 +1036,7 @@ void MqttsnClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             }
 
             m_config.m_subscribes.clear();
+            m_topicTrieDirty = true;
             updated = true;
         }  
     }           
@@ -640,10 +1090,50 @@ void MqttsnClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             }
             
             updated = true;
+            m_topicTrieDirty = true;
             forceCleanSession();
         }  
     }              
 
+    {
+        static const QString* SubscribesImportProps[] = {
+            &aliasSubscribesImportProp(),
+            &subscribesImportProp(),
+        };
+
+        for (auto* p : SubscribesImportProps) {
+            auto var = props.value(*p);
+            if ((!var.isValid()) || (!var.canConvert<QString>())) {
+                continue;
+            }
+
+            importSubscribes(var.value<QString>());
+        }
+    }
+
+    {
+        static const QString* SubscribesExportProps[] = {
+            &aliasSubscribesExportProp(),
+            &subscribesExportProp(),
+        };
+
+        for (auto* p : SubscribesExportProps) {
+            auto var = props.value(*p);
+            if ((!var.isValid()) || (!var.canConvert<QString>())) {
+                continue;
+            }
+
+            exportSubscribes(var.value<QString>());
+        }
+    }
+
+    {
+        auto var = props.value(lastValuesQueryProp());
+        if ((var.isValid()) && (var.canConvert<bool>()) && (var.value<bool>())) {
+            reportLastValuesInternal();
+        }
+    }
+
     if (updated) {
         emit sigConfigChanged();
     }
@@ -654,27 +1144,142 @@ const char* MqttsnClientFilter::debugNameImpl() const
     return "mqtt-sn client filter";
 }
 
-void MqttsnClientFilter::doTick()
+void MqttsnClientFilter::doSpillReplay()
 {
-    assert(m_tickMeasureTs > 0);
-    m_tickMeasureTs = 0;
-
-    assert(m_client);
-    if (!m_client) {
+    if (::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) {
         return;
     }
 
-    ::cc_mqttsn_client_tick(m_client.get(), m_tickMs);
-}
+    m_sendData.clear();
 
-void MqttsnClientFilter::socketConnected()
-{
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket connected report" << std::endl;
+    // The failed records are published again before any newer one is read
+    while ((m_spillInFlight < SpillReadAhead) && (!m_spillRetries.empty())) {
+        auto retry = std::move(m_spillRetries.front());
+        m_spillRetries.pop_front();
+
+        auto opPtr = std::make_unique<PublishOp>();
+        opPtr->m_spillSegment = retry.m_segment;
+        opPtr->m_spillSeq = retry.m_seq;
+        opPtr->m_spillAttempts = retry.m_attempts;
+        opPtr->m_spilled = true;
+        opPtr->m_spillRetry = true;
+        ++m_spillInFlight;
+        ++m_spillRetriesInFlight;
+        publishInternal(std::move(retry.m_dataPtr), std::move(opPtr));
     }
-        
-    auto config = CC_MqttsnConnectConfig();
-    ::cc_mqttsn_client_connect_init_config(&config);
+
+    while ((m_spillRetries.empty()) && 
+           (m_spillRetriesInFlight == 0U) && 
+           (m_spillInFlight < SpillReadAhead) && 
+           (!m_spillLog.isEmpty())) {
+        auto opPtr = std::make_unique<PublishOp>();
+        auto dataPtr = m_spillLog.readNext(opPtr->m_spillSegment);
+        if (!dataPtr) {
+            break;
+        }
+
+        opPtr->m_spillSeq = m_nextSpillSeq++;
+        opPtr->m_spilled = true;
+        ++m_spillInFlight;
+        publishInternal(std::move(dataPtr), std::move(opPtr));
+    }
+
+    reportCollectedSendData();
+}
+
+void MqttsnClientFilter::doDispatch()
+{
+    m_sendData.clear();
+    dispatchLanes();
+    reportCollectedSendData();
+}
+
+void MqttsnClientFilter::doCoalesceFlush()
+{
+    m_sendData.clear();
+    MqttsnClientFilterCoalescer::DataInfosList ready;
+    m_coalescer.takeExpired(monotonicUs(), ready);
+    submitCoalescedInternal(ready);
+    programCoalesceFlush();
+    reportCollectedSendData();
+}
+
+void MqttsnClientFilter::doFragmentRelease()
+{
+    m_sendData.clear();
+    releaseFragmentsInternal();
+    dispatchLanes();
+    reportCollectedSendData();
+}
+
+void MqttsnClientFilter::doProbe()
+{
+    if (::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) {
+        return;
+    }
+
+    auto nowUs = monotonicUs();
+    auto timeoutUs = std::max(MinProbeTimeoutUs, static_cast<qint64>(m_config.m_probeInterval) * 1000 * ProbeTimeoutIntervals);
+    m_probe.expire(nowUs, timeoutUs);
+    m_probe.makeProbe(nowUs, m_probeData);
+
+    auto config = CC_MqttsnPublishConfig();
+    ::cc_mqttsn_client_publish_init_config(&config);
+    config.m_topic = m_probeTopic.c_str();
+    config.m_data = m_probeData.data();
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(m_probeData.size());
+    config.m_qos = static_cast<decltype(config.m_qos)>(m_config.m_probeQos);
+
+    // The probe bypasses the publish pipeline and is not accounted in the traffic statistics
+    auto ec = ::cc_mqttsn_client_publish(m_client.get(), &config, &MqttsnClientFilter::probePublishCompleteCb, this);
+    if (ec != CC_MqttsnErrorCode_Success) {
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): failed to publish probe: " << errorCodeStr(ec).toStdString() << std::endl;
+        }
+        return;
+    }
+
+    m_probe.markSent(nowUs);
+}
+
+void MqttsnClientFilter::doRxFlush()
+{
+    // Without the connected receiver the values remain held until the next recvData()
+    if (!isSignalConnected(QMetaMethod::fromSignal(&MqttsnClientFilter::sigDataReceived))) {
+        return;
+    }
+
+    m_recvData.clear();
+    flushLatestValuesInternal();
+    if (m_recvData.isEmpty()) {
+        return;
+    }
+
+    emit sigDataReceived(std::move(m_recvData));
+    m_recvData.clear();
+}
+
+void MqttsnClientFilter::doTick()
+{
+    assert(m_tickMeasureTs > 0);
+    m_tickMeasureTs = 0;
+
+    assert(m_client);
+    if (!m_client) {
+        return;
+    }
+
+    ::cc_mqttsn_client_tick(m_client.get(), m_tickMs);
+}
+
+void MqttsnClientFilter::socketConnected()
+{
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket connected report" << std::endl;
+    }
+        
+    auto config = CC_MqttsnConnectConfig();
+    ::cc_mqttsn_client_connect_init_config(&config);
 
     auto clientId = m_config.m_clientId.toStdString();
     
@@ -682,53 +1287,1282 @@ void MqttsnClientFilter::socketConnected()
         config.m_clientId = clientId.c_str();
     }
 
-    config.m_duration = m_config.m_keepAlive;
-    config.m_cleanSession = 
-        (m_config.m_forcedCleanSession) ||
-        (clientId.empty()) || 
-        (clientId != m_prevClientId) ||
-        (m_firstConnect);
+    config.m_duration = m_config.m_keepAlive;
+    config.m_cleanSession = 
+        (m_config.m_forcedCleanSession) ||
+        (clientId.empty()) || 
+        (clientId != m_prevClientId) ||
+        (m_firstConnect);
+
+    m_registeredTopics.clear();
+    m_connectTsUs = monotonicUs();
+    m_connectRetryPeriod = m_currRetryPeriod;
+
+    auto ec = 
+        cc_mqttsn_client_connect(
+            m_client.get(), 
+            &config, 
+            nullptr, 
+            &MqttsnClientFilter::connectCompleteCb, 
+            this);
+
+    if (ec != CC_MqttsnErrorCode_Success) {
+        reportError(tr("Failed to initiate MQTT-SN connection"));
+        return;
+    }    
+
+    m_prevClientId = clientId;
+    m_cleanSession = config.m_cleanSession;
+}
+
+void MqttsnClientFilter::socketDisconnected()
+{
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket disconnected report" << std::endl;
+    }
+}
+
+void MqttsnClientFilter::sendPendingData()
+{
+    m_sendData.clear();
+    std::string topic;
+    for (auto& dataPtr : m_pendingData) {
+        outgoingTopicInternal(dataPtr->m_extraProperties, topic);
+        sendOrQueueInternal(std::move(dataPtr), topic);
+    }
+    m_pendingData.clear();
+    releaseFragmentsInternal();
+    dispatchLanes();
+    reportCollectedSendData();
+
+    doSpillReplay();
+}
+
+void MqttsnClientFilter::pendDataInternal(cc_tools_qt::DataInfoPtr dataPtr)
+{
+    bool spill = 
+        m_spillLog.isOpen() && 
+        ((m_config.m_spillThreshold <= m_pendingData.size()) || (spillActiveInternal()));
+
+    if (!spill) {
+        m_pendingData.push_back(std::move(dataPtr));
+        return;
+    }
+
+    if (!m_spillLog.append(*dataPtr)) {
+        reportError(tr("Failed to spill pending MQTTSN data to: ") + m_spillLog.dir());
+        m_pendingData.push_back(std::move(dataPtr));
+        return;
+    }
+
+    if (::cc_mqttsn_client_get_connection_status(m_client.get()) == CC_MqttsnConnectionStatus_Connected) {
+        m_spillTimer.start(0);
+    }
+}
+
+void MqttsnClientFilter::submitDataInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic)
+{
+    if (!m_compressFilters.empty()) {
+        dataPtr = compressInternal(std::move(dataPtr), topic);
+    }
+
+    if ((0U < m_config.m_fragmentSize) && (m_config.m_fragmentSize < dataPtr->m_data.size())) {
+        if (m_fragmenter.split(*dataPtr, m_config.m_fragmentSize)) {
+            releaseFragmentsInternal();
+            return;
+        }
+
+        reportError(tr("Failed to fragment MQTTSN publish data, the fragment size is too small"));
+    }
+
+    // While spilled data is being replayed the new one is appended to the log to preserve the order
+    if ((::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) ||
+        (spillActiveInternal())) {
+        pendDataInternal(std::move(dataPtr));
+        return;
+    }
+
+    sendOrQueueInternal(std::move(dataPtr), topic);
+}
+
+bool MqttsnClientFilter::coalesceInternal(cc_tools_qt::DataInfoPtr& dataPtr, const std::string& topic)
+{
+    if (m_coalesceFilters.empty()) {
+        return false;
+    }
+
+    auto& props = dataPtr->m_extraProperties;
+    if (getOutgoingRetained(props)) {
+        return false;
+    }
+
+    if (!topicMatchesAny(m_coalesceFilters, topic)) {
+        return false;
+    }
+
+    auto key = outgoingTopicKeyInternal(props, topic);
+    key += '\n';
+    key += std::to_string(getOutgoingQos(props, m_config.m_pubQos));
+
+    MqttsnClientFilterCoalescer::DataInfosList ready;
+    m_coalescer.add(key, std::move(dataPtr), monotonicUs(), ready);
+    submitCoalescedInternal(ready);
+    programCoalesceFlush();
+    return true;
+}
+
+void MqttsnClientFilter::submitCoalescedInternal(MqttsnClientFilterCoalescer::DataInfosList& ready)
+{
+    if (ready.empty()) {
+        return;
+    }
+
+    std::string topic;
+    for (auto& dataPtr : ready) {
+        outgoingTopicInternal(dataPtr->m_extraProperties, topic);
+        submitDataInternal(std::move(dataPtr), topic);
+    }
+
+    dispatchLanes();
+}
+
+void MqttsnClientFilter::programCoalesceFlush()
+{
+    auto deadlineUs = m_coalescer.nextDeadlineUs();
+    if (deadlineUs == 0) {
+        m_coalesceTimer.stop();
+        return;
+    }
+
+    auto waitUs = std::max(qint64(0), deadlineUs - monotonicUs());
+    m_coalesceTimer.start(static_cast<int>((waitUs + 999) / 1000));
+}
+
+void MqttsnClientFilter::releaseFragmentsInternal()
+{
+    // While the gateway is not available or the spilled data is replayed the fragments 
+    // are pended with the other messages, so they are spilled instead of kept in memory
+    if ((::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) ||
+        (spillActiveInternal())) {
+        while (m_fragmenter.hasPending()) {
+            pendDataInternal(m_fragmenter.takeNext());
+        }
+        return;
+    }
+
+    auto window = std::max(1U, m_config.m_fragmentWindow);
+    std::string topic;
+    while ((m_fragmentsInFlight.size() < window) && (m_fragmenter.hasPending())) {
+        auto fragment = m_fragmenter.takeNext();
+        m_fragmentsInFlight[fragment.get()] = fragment;
+        outgoingTopicInternal(fragment->m_extraProperties, topic);
+        sendOrQueueInternal(std::move(fragment), topic);
+    }
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilter::compressInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic)
+{
+    auto& data = dataPtr->m_data;
+    if ((data.size() < std::max(std::size_t(m_config.m_compressMinSize), CompressMarkerLen)) ||
+        (static_cast<std::size_t>(std::numeric_limits<int>::max()) < data.size()) ||
+        (!topicMatchesAny(m_compressFilters, topic))) {
+        return dataPtr;
+    }
+
+    auto startUs = monotonicUs();
+    auto compressed = qCompress(data.data(), static_cast<int>(data.size()), m_config.m_compressLevel);
+    auto cpuUs = static_cast<unsigned long long>(std::max(qint64(0), monotonicUs() - startUs));
+    m_compressStats.m_cpuUs += cpuUs;
+
+    auto compressedLen = CompressMarkerLen + static_cast<std::size_t>(compressed.size());
+    if ((compressed.isEmpty()) || (data.size() <= compressedLen)) {
+        ++m_compressStats.m_skipped;
+        return dataPtr;
+    }
+
+    ++m_compressStats.m_compressed;
+    m_compressStats.m_bytesIn += data.size();
+    m_compressStats.m_bytesOut += compressedLen;
+
+    if (3 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): compressed " << data.size() << 
+            " to " << compressedLen << " bytes in " << cpuUs << "us" << std::endl;
+    }
+
+    // The original data info may still be referenced elsewhere, don't modify it
+    auto result = cc_tools_qt::makeDataInfoTimed();
+    result->m_extraProperties = dataPtr->m_extraProperties;
+    result->m_data.reserve(compressedLen);
+    result->m_data.assign(std::begin(CompressMarker), std::end(CompressMarker));
+    result->m_data.insert(result->m_data.end(), compressed.begin(), compressed.end());
+    return result;
+}
+
+bool MqttsnClientFilter::suppressInternal(const cc_tools_qt::DataInfo& info, const std::string& topic)
+{
+    auto& props = info.m_extraProperties;
+    if (!topicMatchesAny(m_dedupFilters, topic)) {
+        return false;
+    }
+
+    auto key = outgoingTopicKeyInternal(props, topic);
+    auto hash = fnv1aHash(info.m_data.data(), info.m_data.size());
+    auto nowUs = monotonicUs();
+
+    bool numeric = false;
+    double value = 0.0;
+    if (0.0 < m_config.m_dedupDeadband) {
+        auto str = QByteArray::fromRawData(reinterpret_cast<const char*>(info.m_data.data()), static_cast<int>(info.m_data.size()));
+        value = str.trimmed().toDouble(&numeric);
+    }
+
+    auto iter = m_dedupEntries.find(key);
+    if (iter != m_dedupEntries.end()) {
+        auto& entry = iter->second;
+        bool heartbeatDue = 
+            (0U < m_config.m_dedupHeartbeat) && 
+            ((static_cast<qint64>(m_config.m_dedupHeartbeat) * 1000000) <= (nowUs - entry.m_lastSentUs));
+
+        bool unchanged = 
+            (entry.m_hash == hash) ||
+            (numeric && entry.m_numeric && (std::abs(value - entry.m_value) <= m_config.m_dedupDeadband));
+
+        if (unchanged && (!heartbeatDue)) {
+            ++entry.m_suppressed;
+            if (3 <= getDebugOutputLevel()) {
+                debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): suppressed unchanged publish: " << key << std::endl;
+            }
+            return true;
+        }
+    }
+    else {
+        iter = m_dedupEntries.emplace(key, DedupEntry()).first;
+    }
+
+    // The reference value is updated only when the publish is sent, so 
+    // the slow drift still gets reported when exceeding the deadband.
+    auto& entry = iter->second;
+    entry.m_hash = hash;
+    entry.m_value = value;
+    entry.m_numeric = numeric;
+    entry.m_lastSentUs = nowUs;
+    ++entry.m_sent;
+    return false;
+}
+
+void MqttsnClientFilter::applyRxLimitsConfig()
+{
+    m_rxLimitRules.clear();
+    m_rxTopicStates.clear();
+    m_rxFlushTimer.stop();
+    unsigned flushInterval = 0U;
+    for (auto& config : m_config.m_rxLimits) {
+        m_rxLimitRules.resize(m_rxLimitRules.size() + 1U);
+        auto& rule = m_rxLimitRules.back();
+        rule.m_topics = splitTopicFilters(config.m_topics);
+        rule.m_mode = config.m_mode;
+        rule.m_rate = config.m_rate;
+        rule.m_intervalUs = static_cast<qint64>(config.m_interval) * 1000;
+
+        if (rule.m_mode == RxLimitMode_LatestValue) {
+            auto interval = std::max(config.m_interval, 1U);
+            flushInterval = (flushInterval == 0U) ? interval : std::min(flushInterval, interval);
+        }
+    }
+
+    // The held latest values are flushed even when nothing else is received
+    if (0U < flushInterval) {
+        m_rxFlushTimer.start(static_cast<int>(flushInterval));
+    }
+}
+
+void MqttsnClientFilter::applyPubRulesConfig()
+{
+    m_pubRules.clear();
+    m_pubRuleCache.clear();
+    m_pubRulesTtl = false;
+    for (auto& config : m_config.m_pubRules) {
+        m_pubRules.resize(m_pubRules.size() + 1U);
+        auto& rule = m_pubRules.back();
+        rule.m_topics = splitTopicFilters(config.m_topics);
+        rule.m_qos = std::min(config.m_qos, 2);
+        rule.m_retain = config.m_retain;
+        rule.m_priority = config.m_priority;
+        rule.m_ttl = config.m_ttl;
+        m_pubRulesTtl = m_pubRulesTtl || (0U < rule.m_ttl);
+    }
+}
+
+void MqttsnClientFilter::applyPubRuleInternal(QVariantMap& props, const std::string& topic)
+{
+    if (topic.empty()) {
+        return;
+    }
+
+    // The rules are matched once per distinct topic
+    auto iter = m_pubRuleCache.find(topic);
+    if (iter == m_pubRuleCache.end()) {
+        if (MaxPubRuleCache <= m_pubRuleCache.size()) {
+            m_pubRuleCache.clear();
+        }
+
+        int ruleIdx = -1;
+        for (auto idx = 0U; idx < m_pubRules.size(); ++idx) {
+            if (topicMatchesAny(m_pubRules[idx].m_topics, topic)) {
+                ruleIdx = static_cast<int>(idx);
+                break;
+            }
+        }
+
+        iter = m_pubRuleCache.emplace(topic, ruleIdx).first;
+    }
+
+    if (iter->second < 0) {
+        return;
+    }
+
+    // The properties explicitly set on the message take precedence
+    auto& rule = m_pubRules[static_cast<unsigned>(iter->second)];
+    if ((0 <= rule.m_qos) && (!props.contains(qosProp())) && (!props.contains(aliasQosProp()))) {
+        props[qosProp()] = rule.m_qos;
+    }
+
+    if ((0 <= rule.m_retain) && (!props.contains(retainedProp())) && (!props.contains(aliasRetainedProp()))) {
+        props[retainedProp()] = (0 < rule.m_retain);
+    }
+
+    if ((0 <= rule.m_priority) && (!props.contains(priorityProp()))) {
+        props[priorityProp()] = rule.m_priority;
+    }
+
+    // Absolute time survives the message being spilled to disk
+    if ((0U < rule.m_ttl) && (!props.contains(expiryProp()))) {
+        props[expiryProp()] = QDateTime::currentMSecsSinceEpoch() + static_cast<qint64>(rule.m_ttl);
+    }
+}
+
+bool MqttsnClientFilter::pubExpiredInternal(const QVariantMap& props) const
+{
+    if (!m_pubRulesTtl) {
+        return false;
+    }
+
+    auto var = props.value(expiryProp());
+    if ((!var.isValid()) || (!var.canConvert<qint64>())) {
+        return false;
+    }
+
+    return var.value<qint64>() < QDateTime::currentMSecsSinceEpoch();
+}
+
+bool MqttsnClientFilter::rxLimitInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx)
+{
+    if (m_rxLimitRules.empty()) {
+        return true;
+    }
+
+    auto iter = m_rxTopicStates.find(topic);
+    if (iter == m_rxTopicStates.end()) {
+        if (MaxRxTopicStates <= m_rxTopicStates.size()) {
+            return true;
+        }
+
+        RxTopicState state;
+        std::string topicStr(topic);
+        for (auto idx = 0U; idx < m_rxLimitRules.size(); ++idx) {
+            if (topicMatchesAny(m_rxLimitRules[idx].m_topics, topicStr)) {
+                state.m_rule = static_cast<int>(idx);
+                break;
+            }
+        }
+
+        iter = m_rxTopicStates.emplace(std::move(topicStr), std::move(state)).first;
+    }
+
+    auto& state = iter->second;
+    if (state.m_rule < 0) {
+        return true;
+    }
+
+    auto& rule = m_rxLimitRules[static_cast<unsigned>(state.m_rule)];
+    auto nowUs = monotonicUs();
+    if (rule.m_mode == RxLimitMode_DropAboveRate) {
+        if (RxRateWindowUs <= (nowUs - state.m_windowStartUs)) {
+            state.m_windowStartUs = nowUs;
+            state.m_windowCount = 0U;
+        }
+
+        if (rule.m_rate <= state.m_windowCount) {
+            ++state.m_dropped;
+            return false;
+        }
+
+        ++state.m_windowCount;
+        ++state.m_passed;
+        return true;
+    }
+
+    if (rule.m_mode == RxLimitMode_LatestValue) {
+        if ((!state.m_pending) && (rule.m_intervalUs <= (nowUs - state.m_lastFlushUs))) {
+            state.m_lastFlushUs = nowUs;
+            ++state.m_passed;
+            return true;
+        }
+
+        if (state.m_pending) {
+            ++state.m_dropped;
+        }
+
+        // The buffer capacity is reused, no allocation after the first messages
+        state.m_latest.assign(data, data + dataLen);
+        state.m_qos = qos;
+        state.m_subIdx = subIdx;
+        state.m_retained = retained;
+        state.m_pending = true;
+        return false;
+    }
+
+    ++state.m_passed;
+    return true;
+}
+
+void MqttsnClientFilter::flushLatestValuesInternal()
+{
+    if (m_rxLimitRules.empty()) {
+        return;
+    }
+
+    auto nowUs = monotonicUs();
+    for (auto& s : m_rxTopicStates) {
+        auto& state = s.second;
+        if ((!state.m_pending) || (state.m_rule < 0)) {
+            continue;
+        }
+
+        auto& rule = m_rxLimitRules[static_cast<unsigned>(state.m_rule)];
+        if ((nowUs - state.m_lastFlushUs) < rule.m_intervalUs) {
+            continue;
+        }
+
+        state.m_pending = false;
+        state.m_lastFlushUs = nowUs;
+        ++state.m_passed;
+        appendReceivedInternal(s.first.c_str(), state.m_latest.data(), state.m_latest.size(), state.m_qos, state.m_retained, state.m_subIdx);
+    }
+}
+
+void MqttsnClientFilter::reportReceivedInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx)
+{
+    if (!rxLimitInternal(topic, data, dataLen, qos, retained, subIdx)) {
+        return;
+    }
+
+    appendReceivedInternal(topic, data, dataLen, qos, retained, subIdx);
+}
+
+void MqttsnClientFilter::appendReceivedInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx)
+{
+    auto dataInfo = m_dataInfoPool.acquire();
+    if (dataLen > 0U) {
+        dataInfo->m_data.assign(data, data + dataLen);
+    }
+    auto& props = dataInfo->m_extraProperties;
+    props = m_recvProps;
+    props[topicProp()] = topic;
+    props[qosProp()] = qos;
+    props[retainedProp()] = retained;
+    if ((0 <= subIdx) && (static_cast<unsigned>(subIdx) < m_subTopics.size())) {
+        props[subIndexProp()] = subIdx;
+        props[subTopicProp()] = m_subTopics[static_cast<unsigned>(subIdx)];
+    }
+    m_recvData.append(std::move(dataInfo));
+}
+
+void MqttsnClientFilter::syncTopicTrie()
+{
+    m_topicTrieDirty = false;
+
+    // Only the added and removed subscription topics are updated in the trie,
+    // the value stored there is kept while the topic is subscribed and is
+    // mapped to the index of its first subscription.
+    std::map<std::string, int> subIndices;
+    m_subTopics.clear();
+    m_subTopics.reserve(m_config.m_subscribes.size());
+    for (auto& sub : m_config.m_subscribes) {
+        auto topic = sub.m_topic.trimmed().toStdString();
+        if (!topic.empty()) {
+            subIndices.emplace(std::move(topic), static_cast<int>(m_subTopics.size()));
+        }
+
+        m_subTopics.push_back(sub.m_topic);
+    }
+
+    for (auto iter = m_trieSubValues.begin(); iter != m_trieSubValues.end(); ) {
+        if (subIndices.find(iter->first) != subIndices.end()) {
+            ++iter;
+            continue;
+        }
+
+        m_topicTrie.remove(iter->first, iter->second);
+        m_trieSubIndices[static_cast<unsigned>(iter->second)] = -1;
+        iter = m_trieSubValues.erase(iter);
+    }
+
+    for (auto& sub : subIndices) {
+        auto iter = m_trieSubValues.find(sub.first);
+        if (iter == m_trieSubValues.end()) {
+            auto unusedIter = std::find(m_trieSubIndices.begin(), m_trieSubIndices.end(), -1);
+            if (unusedIter == m_trieSubIndices.end()) {
+                unusedIter = m_trieSubIndices.insert(m_trieSubIndices.end(), -1);
+            }
+
+            auto value = static_cast<int>(std::distance(m_trieSubIndices.begin(), unusedIter));
+            m_topicTrie.insert(sub.first, value);
+            iter = m_trieSubValues.emplace(sub.first, value).first;
+        }
+
+        m_trieSubIndices[static_cast<unsigned>(iter->second)] = sub.second;
+    }
+
+    auto excludes = splitTopicFilters(m_config.m_rxExcludeTopics);
+    if (excludes == m_trieExcludes) {
+        return;
+    }
+
+    for (auto& filter : m_trieExcludes) {
+        m_topicTrie.remove(filter, TrieExcludeValue);
+    }
+
+    for (auto& filter : excludes) {
+        m_topicTrie.insert(filter, TrieExcludeValue);
+    }
+
+    m_trieExcludes = std::move(excludes);
+}
+
+bool MqttsnClientFilter::outgoingTopicInternal(const QVariantMap& props, std::string& topic)
+{
+    // The configured topic is rendered only when not overridden by the properties
+    if (props.contains(topicProp()) || props.contains(aliasTopicProp())) {
+        topic = getOutgoingTopic(props, std::string());
+        return false;
+    }
+
+    if (getOutgoingTopicId(props, 0U) != 0U) {
+        topic.clear();
+        return false;
+    }
+
+    if (m_pubTopicTemplate.pattern() != m_config.m_pubTopic) {
+        m_pubTopicTemplate.compile(m_config.m_pubTopic);
+    }
+
+    m_pubTopicTemplate.render(props, topic);
+    return m_pubTopicTemplate.hasPlaceholders();
+}
+
+std::string MqttsnClientFilter::outgoingTopicKeyInternal(const QVariantMap& props, const std::string& topic)
+{
+    if (!topic.empty()) {
+        return topic;
+    }
+
+    return '#' + std::to_string(getOutgoingTopicId(props, m_config.m_pubTopicId));
+}
+
+void MqttsnClientFilter::reportLastValuesInternal()
+{
+    auto& entries = m_lastValues.entries();
+    QVariantList valuesList;
+    valuesList.reserve(static_cast<int>(entries.size()));
+
+    // Most recently updated first, the payloads are shared, not copied
+    for (auto iter = entries.rbegin(); iter != entries.rend(); ++iter) {
+        QVariantMap valueMap;
+        valueMap[topicSubProp()] = QString::fromStdString(iter->m_topic);
+        valueMap[dataSubProp()] = iter->m_payload;
+        valueMap[qosSubProp()] = iter->m_qos;
+        valueMap[retainedSubProp()] = iter->m_retained;
+        valuesList.append(QVariant::fromValue(valueMap));
+    }
+
+    QVariantMap props;
+    props[lastValuesProp()] = QVariant::fromValue(valuesList);
+    reportInterPluginConfig(props);
+}
+
+bool MqttsnClientFilter::matchTopicTrie(const char* topic, int& subIdx) const
+{
+    subIdx = -1;
+    bool excluded = false;
+    m_topicTrie.forEachMatch(
+        topic,
+        [this, &subIdx, &excluded](int value)
+        {
+            if (value == TrieExcludeValue) {
+                excluded = true;
+                return;
+            }
+
+            if (m_trieSubIndices.size() <= static_cast<unsigned>(value)) {
+                return;
+            }
+
+            // The first configured subscription takes precedence
+            auto idx = m_trieSubIndices[static_cast<unsigned>(value)];
+            if ((0 <= idx) && ((subIdx < 0) || (idx < subIdx))) {
+                subIdx = idx;
+            }
+        });
+
+    return !excluded;
+}
+
+void MqttsnClientFilter::applyLanesConfig()
+{
+    auto lanesCount = std::max(std::size_t(1U), m_config.m_lanes.size());
+
+    // Messages queued in the removed lanes are moved to the lowest priority one
+    std::deque<QueuedData> orphans;
+    for (auto idx = lanesCount; idx < m_lanes.size(); ++idx) {
+        auto& queue = m_lanes[idx].m_queue;
+        std::move(queue.begin(), queue.end(), std::back_inserter(orphans));
+    }
+
+    m_lanes.resize(lanesCount);
+    auto& lastQueue = m_lanes.back().m_queue;
+    std::move(orphans.begin(), orphans.end(), std::back_inserter(lastQueue));
+
+    auto configIter = m_config.m_lanes.begin();
+    for (auto& lane : m_lanes) {
+        lane.m_topics.clear();
+        lane.m_weight = 1U;
+        if (configIter != m_config.m_lanes.end()) {
+            lane.m_topics = splitTopicFilters(configIter->m_topics);
+            lane.m_weight = std::max(1U, configIter->m_weight);
+            ++configIter;
+        }
+
+        lane.m_credit = std::min(lane.m_credit, lane.m_weight);
+    }
+}
+
+bool MqttsnClientFilter::lanesActive() const
+{
+    // The configured lanes are used for the weighting and the latency
+    // tracking even when the publishes are not limited.
+    return (0U < m_config.m_pubMaxInFlight) || (shaperActive()) || (!m_config.m_lanes.empty());
+}
+
+void MqttsnClientFilter::sendOrQueueInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic)
+{
+    if (!lanesActive()) {
+        publishInternal(std::move(dataPtr));
+        return;
+    }
+
+    enqueueLaneInternal(std::move(dataPtr), topic);
+}
+
+void MqttsnClientFilter::enqueueLaneInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic)
+{
+    assert(!m_lanes.empty());
+    auto& props = dataPtr->m_extraProperties;
+    auto laneIdx = m_lanes.size() - 1U;
+    auto priorityVar = props.value(priorityProp());
+    if (priorityVar.isValid() && priorityVar.canConvert<int>()) {
+        laneIdx = std::min(static_cast<std::size_t>(std::max(0, priorityVar.value<int>())), laneIdx);
+    }
+    else {
+        for (auto idx = 0U; idx < m_lanes.size(); ++idx) {
+            if (topicMatchesAny(m_lanes[idx].m_topics, topic)) {
+                laneIdx = idx;
+                break;
+            }
+        }
+    }
+
+    QueuedData queued;
+    queued.m_topicKey = outgoingTopicKeyInternal(props, topic);
+    queued.m_dataPtr = std::move(dataPtr);
+    queued.m_enqueueTsUs = monotonicUs();
+    m_lanes[laneIdx].m_queue.push_back(std::move(queued));
+}
+
+void MqttsnClientFilter::requeueLaneInternal(cc_tools_qt::DataInfoPtr dataPtr, unsigned laneIdx)
+{
+    assert(!m_lanes.empty());
+    laneIdx = std::min(laneIdx, static_cast<unsigned>(m_lanes.size() - 1U));
+
+    std::string topic;
+    outgoingTopicInternal(dataPtr->m_extraProperties, topic);
+
+    QueuedData queued;
+    queued.m_topicKey = outgoingTopicKeyInternal(dataPtr->m_extraProperties, topic);
+    queued.m_dataPtr = std::move(dataPtr);
+    queued.m_enqueueTsUs = monotonicUs();
+    m_lanes[laneIdx].m_queue.push_front(std::move(queued));
+}
+
+void MqttsnClientFilter::dispatchLanes()
+{
+    if (::cc_mqttsn_client_get_connection_status(m_client.get()) != CC_MqttsnConnectionStatus_Connected) {
+        return;
+    }
+
+    std::size_t maxInFlight = 0U;
+    if (0U < m_config.m_pubMaxInFlight) {
+        maxInFlight = std::max(std::size_t(1U), static_cast<std::size_t>(m_config.m_pubMaxInFlight * m_shaperScale));
+    }
+
+    auto nowUs = monotonicUs();
+    qint64 waitUs = 0;
+    std::vector<bool> blocked(m_lanes.size(), false);
+
+    // Previously queued messages are flushed if the limits have been removed
+    while ((maxInFlight == 0U) || (m_publishOps.size() < maxInFlight)) {
+        auto laneIdx = selectLane(blocked);
+        if (laneIdx < 0) {
+            break;
+        }
+
+        auto pubWaitUs = shaperWaitUs(m_pubBucket, m_config.m_pubRate, nowUs);
+        if (0 < pubWaitUs) {
+            waitUs = (waitUs == 0) ? pubWaitUs : std::min(waitUs, pubWaitUs);
+            break;
+        }
+
+        auto& lane = m_lanes[static_cast<unsigned>(laneIdx)];
+        if (0U < m_config.m_topicPubRate) {
+            auto& bucket = m_topicBuckets[lane.m_queue.front().m_topicKey];
+            auto topicWaitUs = shaperWaitUs(bucket, m_config.m_topicPubRate, nowUs);
+            if (0 < topicWaitUs) {
+                // The order within the lane is preserved, other lanes may proceed
+                blocked[static_cast<unsigned>(laneIdx)] = true;
+                waitUs = (waitUs == 0) ? topicWaitUs : std::min(waitUs, topicWaitUs);
+                continue;
+            }
+
+            bucket.m_tokens -= 1.0;
+        }
+
+        if (0U < m_config.m_pubRate) {
+            m_pubBucket.m_tokens -= 1.0;
+        }
+
+        auto queued = std::move(lane.m_queue.front());
+        lane.m_queue.pop_front();
+        assert(0U < lane.m_credit);
+        --lane.m_credit;
+
+        auto latency = static_cast<unsigned long long>(std::max(qint64(0), monotonicUs() - queued.m_enqueueTsUs));
+        auto& stats = lane.m_stats;
+        ++stats.m_dispatched;
+        stats.m_totalLatencyUs += latency;
+        stats.m_maxLatencyUs = std::max(stats.m_maxLatencyUs, latency);
+
+        if (3 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): dispatching from lane " << laneIdx << " after " << latency << "us" << std::endl;
+        }
+
+        auto opPtr = std::make_unique<PublishOp>();
+        opPtr->m_lane = static_cast<unsigned>(laneIdx);
+        publishInternal(std::move(queued.m_dataPtr), std::move(opPtr));
+    }
+
+    if (0 < waitUs) {
+        m_dispatchTimer.start(static_cast<int>((waitUs + 999) / 1000));
+    }
+
+    if (m_config.m_topicPubRate == 0U) {
+        m_topicBuckets.clear();
+    }
+
+    if (m_topicBuckets.size() <= MaxTopicBuckets) {
+        return;
+    }
+
+    // Drop the buckets of the idle topics, they are full anyway
+    auto burst = static_cast<double>(std::max(1U, m_config.m_pubBurst));
+    for (auto iter = m_topicBuckets.begin(); iter != m_topicBuckets.end(); ) {
+        auto& bucket = iter->second;
+        shaperWaitUs(bucket, m_config.m_topicPubRate, nowUs);
+        if (burst <= bucket.m_tokens) {
+            iter = m_topicBuckets.erase(iter);
+            continue;
+        }
+
+        ++iter;
+    }
+}
+
+int MqttsnClientFilter::selectLane(const std::vector<bool>& blocked)
+{
+    // Higher priority lanes are served first while they have credit. The credits 
+    // are refilled with the lane weight only when all non-empty lanes exhausted 
+    // them, so the lower priority lanes always get their share.
+    for (auto attempt = 0; attempt < 2; ++attempt) {
+        for (auto idx = 0U; idx < m_lanes.size(); ++idx) {
+            auto& lane = m_lanes[idx];
+            if ((!lane.m_queue.empty()) && (0U < lane.m_credit) && (!blocked[idx])) {
+                return static_cast<int>(idx);
+            }
+        }
+
+        for (auto& lane : m_lanes) {
+            lane.m_credit = lane.m_weight;
+        }
+    }
+
+    return -1;
+}
+
+bool MqttsnClientFilter::shaperActive() const
+{
+    return (0U < m_config.m_pubRate) || (0U < m_config.m_topicPubRate);
+}
+
+qint64 MqttsnClientFilter::shaperWaitUs(TokenBucket& bucket, unsigned rate, qint64 nowUs) const
+{
+    if (rate == 0U) {
+        return 0;
+    }
+
+    auto effRate = std::max(static_cast<double>(rate) * m_shaperScale, MinShaperScale);
+    auto burst = static_cast<double>(std::max(1U, m_config.m_pubBurst));
+    if (bucket.m_lastTsUs == 0) {
+        bucket.m_tokens = burst;
+    }
+    else if (bucket.m_lastTsUs < nowUs) {
+        bucket.m_tokens = std::min(burst, bucket.m_tokens + ((static_cast<double>(nowUs - bucket.m_lastTsUs) * effRate) / 1000000.0));
+    }
+
+    bucket.m_lastTsUs = std::max(bucket.m_lastTsUs, nowUs);
+    if (1.0 <= bucket.m_tokens) {
+        return 0;
+    }
+
+    return static_cast<qint64>(std::ceil(((1.0 - bucket.m_tokens) * 1000000.0) / effRate));
+}
+
+void MqttsnClientFilter::shaperBackoff()
+{
+    m_shaperScale = std::max(MinShaperScale, m_shaperScale / 2);
+    m_pubBucket.m_tokens = std::min(m_pubBucket.m_tokens, 0.0);
+
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish rate scaled down to " << m_shaperScale << std::endl;
+    }
+}
+
+void MqttsnClientFilter::shaperRecover()
+{
+    m_shaperScale = std::min(1.0, m_shaperScale + ShaperRecoverStep);
+}
+
+bool MqttsnClientFilter::publishInternal(cc_tools_qt::DataInfoPtr dataPtr, PublishOpPtr opPtr)
+{
+    if (!opPtr) {
+        opPtr = std::make_unique<PublishOp>();
+    }
+
+    opPtr->m_filter = this;
+    if (m_fragmentsInFlight.find(dataPtr.get()) != m_fragmentsInFlight.end()) {
+        opPtr->m_fragment = dataPtr.get();
+    }
+
+    // Kept to be queued again if rejected due to congestion
+    opPtr->m_dataPtr = dataPtr;
+
+    if (pubExpiredInternal(dataPtr->m_extraProperties)) {
+        ++m_pubExpired;
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): dropped expired message" << std::endl;
+        }
+
+        // Releases the spill record and the fragment slot
+        auto* op = opPtr.get();
+        m_publishOps[op] = std::move(opPtr);
+        publishOpComplete(*op);
+        return false;
+    }
+
+    auto& props = dataPtr->m_extraProperties;
+    std::string topic;
+    outgoingTopicInternal(props, topic);
+    auto topicId = getOutgoingTopicId(props, m_config.m_pubTopicId);
+    
+    auto qos = getOutgoingQos(props, m_config.m_pubQos);
+    props[qosProp()] = qos;
+
+    auto retained = getOutgoingRetained(props);
+    props[retainedProp()] = retained;
+
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish: " << topic << std::endl;
+    }    
+
+    auto config = CC_MqttsnPublishConfig();
+    ::cc_mqttsn_client_publish_init_config(&config);
+
+    if (!topic.empty()) {
+        config.m_topic = topic.c_str();
+        props[topicProp()] = QString::fromStdString(topic);
+    }
+    else if (topicId != 0U) {
+        config.m_topicId = static_cast<decltype(config.m_topicId)>(topicId);
+        props[topicIdProp()] = topicId;
+    }
+    config.m_data = dataPtr->m_data.data();
+    config.m_dataLen = static_cast<decltype(config.m_dataLen)>(dataPtr->m_data.size());
+    config.m_qos = static_cast<decltype(config.m_qos)>(qos);    
+    config.m_retain = retained;
+
+    m_sendDataPtr = std::move(dataPtr);
 
-    auto ec = 
-        cc_mqttsn_client_connect(
-            m_client.get(), 
-            &config, 
-            nullptr, 
-            &MqttsnClientFilter::connectCompleteCb, 
-            this);
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): initiating publish" << std::endl;
+    }    
+
+    opPtr->m_startTsUs = monotonicUs();
+    opPtr->m_retryPeriod = m_currRetryPeriod;
+    // QoS0 publish is not acknowledged, QoS2 one requires two round trips 
+    // and the first publish to a topic is preceded by its registration.
+    opPtr->m_roundTrips = (qos <= 0) ? 0U : static_cast<unsigned>(std::min(qos, 2));
+    bool registration = 
+        (!topic.empty()) && 
+        (topic.size() != ShortTopicNameLen) && 
+        (m_registeredTopics.find(topic) == m_registeredTopics.end());
+
+    if (registration) {
+        // The library keeps its own registrations, the bounded cache only 
+        // estimates the extra round trip.
+        if (MaxRegisteredTopics <= m_registeredTopics.size()) {
+            m_registeredTopics.clear();
+        }
+
+        m_registeredTopics.insert(topic);
+    }
+
+    if ((0U < opPtr->m_roundTrips) && registration) {
+        ++opPtr->m_roundTrips;
+    }
+
+    auto* op = opPtr.get();
+    m_publishOps[op] = std::move(opPtr);
+
+    auto ec = ::cc_mqttsn_client_publish(m_client.get(), &config, &MqttsnClientFilter::publishCompleteCb, op);
+    m_sendDataPtr.reset();
 
     if (ec != CC_MqttsnErrorCode_Success) {
-        reportError(tr("Failed to initiate MQTT-SN connection"));
+        reportError(tr("Failed to send MQTTSN publish with error: ") + errorCodeStr(ec));
+        publishOpComplete(*op);
+        return false;        
+    }
+
+    ++m_published;
+    if (m_topicStats.isEnabled()) {
+        // The publishes by the predefined topic ID are accounted as "#<id>",
+        // which cannot clash with a valid topic name.
+        auto dataLen = static_cast<std::size_t>(config.m_dataLen);
+        auto tsMs = QDateTime::currentMSecsSinceEpoch();
+        if (!topic.empty()) {
+            m_topicStats.addTx(topic, dataLen, qos, tsMs);
+        }
+        else {
+            m_topicStats.addTx('#' + std::to_string(topicId), dataLen, qos, tsMs);
+        }
+    }
+
+    return true;
+}
+
+void MqttsnClientFilter::publishOpComplete(const PublishOp& op, bool retry, bool timeout)
+{
+    auto iter = m_publishOps.find(&op);
+    if (iter == m_publishOps.end()) {
+        assert(false); // Should not happen
         return;
-    }    
+    }
+
+    auto opPtr = std::move(iter->second);
+    m_publishOps.erase(iter);
+
+    if (lanesActive()) {
+        m_dispatchTimer.start(0);
+    }
+
+    if (opPtr->m_fragment != nullptr) {
+        m_fragmentsInFlight.erase(opPtr->m_fragment);
+        m_fragmentTimer.start(0);
+    }
+
+    if (!opPtr->m_spilled) {
+        return;
+    }
+
+    if (0U < m_spillInFlight) {
+        --m_spillInFlight;
+    }
+
+    if ((opPtr->m_spillRetry) && (0U < m_spillRetriesInFlight)) {
+        --m_spillRetriesInFlight;
+    }
+
+    auto attempts = opPtr->m_spillAttempts + (timeout ? 1U : 0U);
+    if (retry && (opPtr->m_dataPtr) && (attempts < SpillMaxAttempts)) {
+        // The record is not released and its message is published again 
+        // after the retry period, the replay of the newer ones is paused 
+        // until it is delivered.
+        SpillRetry spillRetry;
+        spillRetry.m_dataPtr = std::move(opPtr->m_dataPtr);
+        spillRetry.m_segment = opPtr->m_spillSegment;
+        spillRetry.m_seq = opPtr->m_spillSeq;
+        spillRetry.m_attempts = attempts;
+
+        auto iter = 
+            std::upper_bound(
+                m_spillRetries.begin(), m_spillRetries.end(), spillRetry.m_seq,
+                [](unsigned long long seq, const SpillRetry& elem)
+                {
+                    return seq < elem.m_seq;
+                });
+
+        m_spillRetries.insert(iter, std::move(spillRetry));
+        m_spillTimer.start(static_cast<int>(m_currRetryPeriod));
+        return;
+    }
+
+    if (retry) {
+        reportError(tr("Dropped spilled MQTTSN publish after %1 timeouts").arg(attempts));
+    }
+
+    m_spillLog.release(opPtr->m_spillSegment);
+    m_spillTimer.start(0);
+}
+
+bool MqttsnClientFilter::spillActiveInternal() const
+{
+    return (!m_spillLog.isEmpty()) || (!m_spillRetries.empty()) || (0U < m_spillRetriesInFlight);
+}
+
+void MqttsnClientFilter::captureFailedInternal()
+{
+    // The capture is closed when its mapping cannot be extended
+    reportError(tr("Failed to extend MQTTSN capture file, capturing is stopped: ") + m_config.m_captureFile);
+}
+
+void MqttsnClientFilter::reportCollectedSendData()
+{
+    for (auto& dataPtr : m_sendData) {
+        reportDataToSend(std::move(dataPtr));
+    }
+    m_sendData.clear();
+}
+
+void MqttsnClientFilter::loadSessionState()
+{
+    // The stored session is not resumed after the clean one has been forced
+    if ((!m_firstConnect) || (m_cleanSessionForced) || (m_config.m_forcedCleanSession)) {
+        return;
+    }
+
+    m_sessionStore.close();
+    if (m_config.m_sessionFile.isEmpty()) {
+        return;
+    }
+
+    if (!m_sessionStore.load(m_config.m_sessionFile)) {
+        return;
+    }
+
+    auto clientId = m_config.m_clientId.toStdString();
+    if (clientId != m_sessionStore.clientId()) {
+        m_sessionStore.close();
+        return;
+    }
+
+    // Every subscription stored in the session must still be configured, 
+    // otherwise clean session is required. The loopback probe topic is
+    // stored as a regular subscription.
+    auto probeTopic = m_config.m_probeTopic.trimmed().toStdString();
+    for (auto& info : m_sessionStore.subscribes()) {
+        if ((!probeTopic.empty()) && 
+            (info.m_topic == probeTopic) && 
+            (info.m_topicId == 0U) && 
+            (info.m_qos == m_config.m_probeQos)) {
+            continue;
+        }
+
+        auto iter = 
+            std::find_if(
+                m_config.m_subscribes.begin(), m_config.m_subscribes.end(),
+                [&info](const auto& sub)
+                {
+                    return 
+                        (sub.m_topic.trimmed().toStdString() == info.m_topic) &&
+                        (static_cast<unsigned>(sub.m_topicId) == info.m_topicId) &&
+                        (sub.m_maxQos == info.m_qos);
+                });
+
+        if (iter == m_config.m_subscribes.end()) {
+            m_sessionStore.close();
+            return;
+        }
+    }
+
+    if (2 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): resuming stored session of " << clientId << std::endl;
+    }  
 
     m_prevClientId = clientId;
-    m_cleanSession = config.m_cleanSession;
+    m_firstConnect = false;
 }
 
-void MqttsnClientFilter::socketDisconnected()
+void MqttsnClientFilter::resetSessionState()
+{
+    if (m_config.m_sessionFile.isEmpty()) {
+        m_sessionStore.close();
+        return;
+    }
+
+    if (!m_sessionStore.reset(m_config.m_sessionFile, m_prevClientId)) {
+        reportError(tr("Failed to write MQTT-SN session state file: ") + m_config.m_sessionFile);
+    }
+}
+
+void MqttsnClientFilter::subscribeInternal(const SubConfig& sub)
+{
+    auto opPtr = std::make_unique<SubscribeOp>();
+    opPtr->m_filter = this;
+    opPtr->m_topic = sub.m_topic.trimmed().toStdString();
+    opPtr->m_topicId = static_cast<unsigned>(sub.m_topicId);
+    opPtr->m_qos = sub.m_maxQos;
+    opPtr->m_startTsUs = monotonicUs();
+    opPtr->m_retryPeriod = m_currRetryPeriod;
+
+    auto config = CC_MqttsnSubscribeConfig();
+    ::cc_mqttsn_client_subscribe_init_config(&config);
+    if (!opPtr->m_topic.empty()) {
+        config.m_topic = opPtr->m_topic.c_str();
+    }
+    config.m_topicId = static_cast<decltype(config.m_topicId)>(opPtr->m_topicId);
+    config.m_qos = static_cast<decltype(config.m_qos)>(opPtr->m_qos);
+
+    auto* op = opPtr.get();
+    m_subscribeOps[op] = std::move(opPtr);
+
+    auto ec = cc_mqttsn_client_subscribe(m_client.get(), &config, &MqttsnClientFilter::subscribeCompleteCb, op);
+    if (ec != CC_MqttsnErrorCode_Success) {
+        reportError(tr("Failed to send MQTTSN SUBSCRIBE message for topic: ") + sub.m_topic);
+        m_subscribeOps.erase(op);
+        return;
+    }         
+}
+
+void MqttsnClientFilter::rttSampleInternal(qint64 startTsUs, unsigned retryPeriod, unsigned roundTrips)
+{
+    assert(0U < roundTrips);
+    auto elapsedUs = monotonicUs() - startTsUs;
+    if ((startTsUs <= 0) || (elapsedUs < 0)) {
+        return;
+    }
+
+    auto sampleMs = static_cast<double>(elapsedUs) / 1000.0 / roundTrips;
+
+    // Karn's algorithm: the acknowledgement of the retransmitted message 
+    // cannot be matched to a specific transmission, so the sample is 
+    // dropped and the retry period is backed off instead.
+    if ((0U < retryPeriod) && (static_cast<double>(retryPeriod) <= sampleMs)) {
+        rttBackoffInternal();
+        return;
+    }
+
+    m_rtt.addSample(sampleMs);
+
+    if (3 <= getDebugOutputLevel()) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): RTT sample: " << sampleMs << 
+            "ms, srtt: " << m_rtt.srtt() << "ms, rttvar: " << m_rtt.rttVar() << "ms" << std::endl;
+    }
+
+    if (!m_config.m_adaptiveRetry) {
+        return;
+    }
+
+    auto now = monotonicUs();
+    if ((0 < m_rttTuneTsUs) && ((now - m_rttTuneTsUs) < RttRetuneIntervalUs)) {
+        return;
+    }
+
+    m_rttTuneTsUs = now;
+    applyRetryPeriod(m_rtt.retryPeriod(m_config.m_minRetryPeriod, m_config.m_maxRetryPeriod));
+}
+
+void MqttsnClientFilter::rttBackoffInternal()
+{
+    if (!m_config.m_adaptiveRetry) {
+        return;
+    }
+
+    auto maxPeriod = std::max(m_config.m_minRetryPeriod, m_config.m_maxRetryPeriod);
+    auto period = std::min(std::max(m_currRetryPeriod, 1U) * 2U, maxPeriod);
+    m_rttTuneTsUs = monotonicUs();
+    applyRetryPeriod(period);
+}
+
+void MqttsnClientFilter::applyRetryPeriod(unsigned period)
 {
+    if (period == m_currRetryPeriod) {
+        return;
+    }
+
+    auto ec = ::cc_mqttsn_client_set_default_retry_period(m_client.get(), period);
+    if (ec != CC_MqttsnErrorCode_Success) {
+        reportError(tr("Failed to update MQTT-SN default retry period with error: ") + errorCodeStr(ec));
+        return;
+    }
+
     if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket disconnected report" << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): retry period updated to " << period << "ms" << std::endl;
     }
+
+    m_currRetryPeriod = period;
 }
 
-void MqttsnClientFilter::sendPendingData()
+void MqttsnClientFilter::startProbeInternal()
 {
-    for (auto& dataPtr : m_pendingData) {
-        sendDataImpl(std::move(dataPtr));
+    if (m_probeTopic.empty()) {
+        return;
     }
-    m_pendingData.clear();
+
+    // Re-subscription to the loopback topic is harmless, the gateway just confirms it
+    if (m_cleanSession || (!m_sessionStore.isOpen()) || 
+        (!m_sessionStore.hasSubscribe(m_probeTopic, 0U, m_config.m_probeQos))) {
+        SubConfig sub;
+        sub.m_topic = QString::fromStdString(m_probeTopic);
+        sub.m_maxQos = m_config.m_probeQos;
+        subscribeInternal(sub);
+    }
+
+    m_probeTimer.start(static_cast<int>(std::max(m_config.m_probeInterval, MinProbeInterval)));
 }
 
 void MqttsnClientFilter::sendDataInternal(const unsigned char* buf, unsigned bufLen, unsigned broadcastRadius)
 {
     if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): sending " << bufLen << " bytes" << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): sending " << bufLen << " bytes" << std::endl;
     }
 
-    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
+    auto dataInfo = m_dataInfoPool.acquire();
     dataInfo->m_data.assign(buf, buf + bufLen);
+    if ((m_capture.isOpen()) && (!m_capture.append(MqttsnClientFilterCapture::Direction_Out, buf, bufLen))) {
+        captureFailedInternal();
+    }
+
+    if (isRetransmit(buf, bufLen)) {
+        ++m_retransmits;
+    }
+
     if (!m_sendDataPtr) {
         reportDataToSend(std::move(dataInfo));
         return;
@@ -749,7 +2583,7 @@ void MqttsnClientFilter::sendDataInternal(const unsigned char* buf, unsigned buf
 void MqttsnClientFilter::gwDisconnectedInternal(CC_MqttsnGatewayDisconnectReason reason)
 {
     if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): gateway disconnected: " <<  disconnectReasonStr(reason).toStdString() << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): gateway disconnected: " <<  disconnectReasonStr(reason).toStdString() << std::endl;
     }
 
     auto gatewayDisconnecteError = 
@@ -761,27 +2595,109 @@ void MqttsnClientFilter::gwDisconnectedInternal(CC_MqttsnGatewayDisconnectReason
 void MqttsnClientFilter::messageReceivedInternal(const CC_MqttsnMessageInfo& info)
 {
     if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): app message received: " << info.m_topic << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): app message received: " << info.m_topic << std::endl;
     }
 
     assert(m_recvDataPtr);
-    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
-    if (info.m_dataLen > 0U) {
-        dataInfo->m_data.assign(info.m_data, info.m_data + info.m_dataLen);
-    }
-    auto& props = dataInfo->m_extraProperties;
-    props = m_recvDataPtr->m_extraProperties;
     assert(info.m_topic != nullptr);
-    props[topicProp()] = info.m_topic;
-    props[qosProp()] = static_cast<int>(info.m_qos);
-    props[retainedProp()] = info.m_retained;
-    m_recvData.append(std::move(dataInfo));
+    if ((!m_probeTopic.empty()) && (m_probeTopic == info.m_topic)) {
+        // The probes are consumed here and never reported to the application
+        if ((!m_probe.match(info.m_data, info.m_dataLen, monotonicUs())) && (2 <= getDebugOutputLevel())) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): dropped foreign probe message" << std::endl;
+        }
+        return;
+    }
+
+    // The checks below don't allocate, the dropped messages are not accounted as received
+    std::string_view topic(info.m_topic);
+
+    // The message ID is not reported by the library, the QoS1 redelivery is
+    // detected by the DUP flag and the same payload received on the same topic 
+    // within the window. The repeated publish without the DUP flag, such as 
+    // the unchanged value heartbeat, is a new message and is reported.
+    if ((0U < m_config.m_rxDedupWindow) && 
+        (info.m_qos == CC_MqttsnQoS_AtLeastOnceDelivery) &&
+        (topicMatchesAny(m_rxDedupFilters, topic))) {
+        auto hash = fnv1aHash(reinterpret_cast<const std::uint8_t*>(topic.data()), topic.size());
+        hash = fnv1aHash(info.m_data, info.m_dataLen, hash);
+        if (m_rxDupTable.checkAndInsert(hash, monotonicUs()) && m_rxFrameDup) {
+            ++m_rxDuplicates;
+            if (2 <= getDebugOutputLevel()) {
+                debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): dropped duplicate message: " << info.m_topic << std::endl;
+            }
+            return;
+        }
+    }
+
+    if (m_topicTrieDirty) {
+        syncTopicTrie();
+    }
+
+    int subIdx = -1;
+    if (!matchTopicTrie(info.m_topic, subIdx)) {
+        ++m_rxExcluded;
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): dropped excluded message: " << info.m_topic << std::endl;
+        }
+        return;
+    }
+
+    ++m_received;
+    if (m_topicStats.isEnabled()) {
+        m_topicStats.addRx(info.m_topic, info.m_dataLen, static_cast<int>(info.m_qos), QDateTime::currentMSecsSinceEpoch());
+    }
+
+    auto* payload = info.m_data;
+    std::size_t payloadLen = info.m_dataLen;
+    if (topicMatchesAny(m_reassemblyFilters, topic)) {
+        auto result = m_fragmenter.reassemble(topic, payload, payloadLen, monotonicUs(), m_reassembled);
+        if (result == MqttsnClientFilterFragmenter::ReassembleResult_Incomplete) {
+            return;
+        }
+
+        if (result == MqttsnClientFilterFragmenter::ReassembleResult_Dropped) {
+            reportError(tr("Dropped MQTTSN fragment exceeding reassembly limits on topic: ") + info.m_topic);
+            return;
+        }
+
+        if (result == MqttsnClientFilterFragmenter::ReassembleResult_Complete) {
+            payload = m_reassembled.data();
+            payloadLen = m_reassembled.size();
+        }
+    }
+
+    if ((CompressMarkerLen < payloadLen) && 
+        (std::equal(std::begin(CompressMarker), std::end(CompressMarker), payload)) &&
+        (topicMatchesAny(m_compressFilters, topic))) {
+        m_decompressed = qUncompress(payload + CompressMarkerLen, static_cast<int>(payloadLen - CompressMarkerLen));
+        if (!m_decompressed.isEmpty()) {
+            payload = reinterpret_cast<const std::uint8_t*>(m_decompressed.constData());
+            payloadLen = static_cast<std::size_t>(m_decompressed.size());
+        }
+    }
+
+    bool coalesced = topicMatchesAny(m_coalesceFilters, topic);
+
+    if (coalesced && MqttsnClientFilterCoalescer::unpack(payload, payloadLen, m_coalescedRecords)) {
+        if ((m_lastValues.isEnabled()) && (!m_coalescedRecords.empty())) {
+            auto& lastRec = m_coalescedRecords.back();
+            m_lastValues.update(info.m_topic, lastRec.first, lastRec.second, static_cast<int>(info.m_qos), info.m_retained);
+        }
+
+        for (auto& rec : m_coalescedRecords) {
+            reportReceivedInternal(info.m_topic, rec.first, rec.second, static_cast<int>(info.m_qos), info.m_retained, subIdx);
+        }
+        return;
+    }
+
+    m_lastValues.update(info.m_topic, payload, payloadLen, static_cast<int>(info.m_qos), info.m_retained);
+    reportReceivedInternal(info.m_topic, payload, payloadLen, static_cast<int>(info.m_qos), info.m_retained, subIdx);
 }
 
 void MqttsnClientFilter::nextTickProgramInternal(unsigned ms)
 {
     if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): tick request: " << ms << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): tick request: " << ms << std::endl;
     }
 
     assert(!m_timer.isActive());
@@ -802,7 +2718,7 @@ unsigned MqttsnClientFilter::cancelTickProgramInternal()
     m_tickMeasureTs = 0U;
 
     if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): cancel tick: " << diff << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): cancel tick: " << diff << std::endl;
     }
         
     return static_cast<unsigned>(diff);
@@ -810,6 +2726,14 @@ unsigned MqttsnClientFilter::cancelTickProgramInternal()
 
 void MqttsnClientFilter::connectCompleteInternal(CC_MqttsnAsyncOpStatus status, const CC_MqttsnConnectInfo* info)
 {
+    if (status == CC_MqttsnAsyncOpStatus_Complete) {
+        rttSampleInternal(m_connectTsUs, m_connectRetryPeriod, 1U);
+    }
+    else if (status == CC_MqttsnAsyncOpStatus_Timeout) {
+        ++m_timeouts;
+        rttBackoffInternal();
+    }
+
     if (status != CC_MqttsnAsyncOpStatus_Complete) {
         reportError(tr("Failed to connect to MQTTSN gateway with status: ") + statusStr(status));
         return;
@@ -822,53 +2746,145 @@ void MqttsnClientFilter::connectCompleteInternal(CC_MqttsnAsyncOpStatus status,
     }
 
     m_firstConnect = false;
+    m_cleanSessionForced = false;
 
-    sendPendingData();
-
-    if (!m_cleanSession) {
-        return;
+    if (m_cleanSession) {
+        resetSessionState();
     }
 
+    sendPendingData();
+    startProbeInternal();
+
     if (m_config.m_subscribes.empty()) {
         return;
     }
 
     for (auto& sub : m_config.m_subscribes) {
-        auto topicStr = sub.m_topic.trimmed().toStdString();
-
-        auto config = CC_MqttsnSubscribeConfig();
-        ::cc_mqttsn_client_subscribe_init_config(&config);
-        if (!topicStr.empty()) {
-            config.m_topic = topicStr.c_str();
+        if ((!m_cleanSession) && 
+            ((!m_sessionStore.isOpen()) ||
+             (m_sessionStore.hasSubscribe(sub.m_topic.trimmed().toStdString(), static_cast<unsigned>(sub.m_topicId), sub.m_maxQos)))) {
+            continue;
         }
-        config.m_topicId = static_cast<decltype(config.m_topicId)>(sub.m_topicId);
-        config.m_qos = static_cast<decltype(config.m_qos)>(sub.m_maxQos);
 
-        auto ec = cc_mqttsn_client_subscribe(m_client.get(), &config, &MqttsnClientFilter::subscribeCompleteCb, this);
-        if (ec != CC_MqttsnErrorCode_Success) {
-            reportError(tr("Failed to send MQTTSN SUBSCRIBE message for topic: ") + config.m_topic);
-            continue;
-        }         
+        subscribeInternal(sub);
     }
 }
 
-void MqttsnClientFilter::subscribeCompleteInternal([[maybe_unused]] CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info)
+void MqttsnClientFilter::subscribeCompleteInternal(const SubscribeOp& op, [[maybe_unused]] CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info)
 {
+    auto opPtr = std::move(m_subscribeOps[&op]);
+    m_subscribeOps.erase(&op);
+    assert(opPtr);
+
+    if (status == CC_MqttsnAsyncOpStatus_Complete) {
+        rttSampleInternal(op.m_startTsUs, op.m_retryPeriod, 1U);
+    }
+    else if (status == CC_MqttsnAsyncOpStatus_Timeout) {
+        ++m_timeouts;
+        rttBackoffInternal();
+    }
+
     if (status != CC_MqttsnAsyncOpStatus_Complete) {
         reportError(tr("Failed to subsribe to MQTTSN topic with status: ") + statusStr(status));
         return;
     }  
 
     assert (info != nullptr);
+    if (info->m_returnCode == CC_MqttsnReturnCode_Conjestion) {
+        shaperBackoff();
+
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): subscribe congested, retrying: " << op.m_topic << std::endl;
+        }
+
+        SubConfig sub;
+        sub.m_topic = QString::fromStdString(op.m_topic);
+        sub.m_topicId = static_cast<int>(op.m_topicId);
+        sub.m_maxQos = op.m_qos;
+        QTimer::singleShot(
+            static_cast<int>(m_currRetryPeriod), this, 
+            [this, sub]()
+            {
+                if (::cc_mqttsn_client_get_connection_status(m_client.get()) == CC_MqttsnConnectionStatus_Connected) {
+                    subscribeInternal(sub);
+                }
+            });
+        return;
+    }
+
     if (info->m_returnCode != CC_MqttsnReturnCode_Accepted) {
         reportError(tr("MQTT gateway rejected subscribe with return code: ") + returnCodeStr(info->m_returnCode));
+        return;
     }
+
+    m_sessionStore.addSubscribe(op.m_topic, op.m_topicId, op.m_qos);
 }
 
-void MqttsnClientFilter::publishCompleteInternal([[maybe_unused]] CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info)
+void MqttsnClientFilter::publishCompleteInternal(const PublishOp& op, [[maybe_unused]] CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info)
 {
+    bool acked = (status == CC_MqttsnAsyncOpStatus_Complete) && (0U < op.m_roundTrips);
+    bool congested = 
+        (status == CC_MqttsnAsyncOpStatus_Complete) && 
+        (info != nullptr) && 
+        (info->m_returnCode == CC_MqttsnReturnCode_Conjestion);
+
+    if (acked) {
+        rttSampleInternal(op.m_startTsUs, op.m_retryPeriod, op.m_roundTrips);
+    }
+    else if (status == CC_MqttsnAsyncOpStatus_Timeout) {
+        ++m_timeouts;
+        rttBackoffInternal();
+    }
+
+    if (congested || (status == CC_MqttsnAsyncOpStatus_Timeout)) {
+        shaperBackoff();
+    }
+    else if (acked && ((info == nullptr) || (info->m_returnCode == CC_MqttsnReturnCode_Accepted))) {
+        shaperRecover();
+    }
+
+    if (congested && op.m_spilled) {
+        // Published again from the spill log after the retry period
+        publishOpComplete(op, true);
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): spilled publish congested, retrying" << std::endl;
+        }
+        return;
+    }
+
+    cc_tools_qt::DataInfoPtr requeuedPtr;
+    auto* fragment = op.m_fragment;
+    if (congested && op.m_dataPtr) {
+        // The message is published again when the shaper allows it
+        requeuedPtr = op.m_dataPtr;
+        requeueLaneInternal(op.m_dataPtr, op.m_lane);
+    }
+
+    bool retry = 
+        (status == CC_MqttsnAsyncOpStatus_Timeout) || 
+        (status == CC_MqttsnAsyncOpStatus_Aborted) || 
+        (status == CC_MqttsnAsyncOpStatus_GatewayDisconnected);
+    publishOpComplete(op, retry, status == CC_MqttsnAsyncOpStatus_Timeout);
+
+    if (requeuedPtr) {
+        if (fragment != nullptr) {
+            // Still occupies the fragments window
+            m_fragmentsInFlight[fragment] = std::move(requeuedPtr);
+        }
+
+        if (!lanesActive()) {
+            // No shaping is configured, the gateway is given the retry period to recover
+            m_dispatchTimer.start(static_cast<int>(m_currRetryPeriod));
+        }
+
+        if (2 <= getDebugOutputLevel()) {
+            debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish congested, requeued" << std::endl;
+        }
+        return;
+    }
+
     if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish complete with status: " << statusStr(status).toStdString() << std::endl;
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish complete with status: " << statusStr(status).toStdString() << std::endl;
     }  
 
     if (status != CC_MqttsnAsyncOpStatus_Complete) {
@@ -882,6 +2898,14 @@ void MqttsnClientFilter::publishCompleteInternal([[maybe_unused]] CC_MqttsnPubli
     }
 }
 
+void MqttsnClientFilter::probePublishCompleteInternal(CC_MqttsnAsyncOpStatus status)
+{
+    // The lost probe is accounted when its echo is not received in time
+    if ((status != CC_MqttsnAsyncOpStatus_Complete) && (2 <= getDebugOutputLevel())) {
+        debugOut() << '[' << currTimestamp() << "] (" << debugNameImpl() << "): probe publish failed with status: " << statusStr(status).toStdString() << std::endl;
+    }
+}
+
 void MqttsnClientFilter::sendDataCb(void* data, const unsigned char* buf, unsigned bufLen, unsigned broadcastRadius)
 {
     asThis(data)->sendDataInternal(buf, bufLen, broadcastRadius);
@@ -931,12 +2955,21 @@ void MqttsnClientFilter::disconnectCompleteCb([[maybe_unused]] void* data, [[may
 
 void MqttsnClientFilter::subscribeCompleteCb(void* data, CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info)
 {
-    asThis(data)->subscribeCompleteInternal(handle, status, info);
+    auto* op = reinterpret_cast<const SubscribeOp*>(data);
+    assert(op != nullptr);
+    op->m_filter->subscribeCompleteInternal(*op, handle, status, info);
 }
 
 void MqttsnClientFilter::publishCompleteCb(void* data, CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info)
 {
-    asThis(data)->publishCompleteInternal(handle, status, info);
+    auto* op = reinterpret_cast<const PublishOp*>(data);
+    assert(op != nullptr);
+    op->m_filter->publishCompleteInternal(*op, handle, status, info);
+}
+
+void MqttsnClientFilter::probePublishCompleteCb(void* data, [[maybe_unused]] CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, [[maybe_unused]] const CC_MqttsnPublishInfo* info)
+{
+    asThis(data)->probePublishCompleteInternal(status);
 }
 
 }  // namespace cc_plugin_mqttsn_client_filter
@@ -18,6 +18,21 @@
 
 #pragma once
 
+#include "MqttsnClientFilterCapture.h"
+#include "MqttsnClientFilterCoalescer.h"
+#include "MqttsnClientFilterDataInfoPool.h"
+#include "MqttsnClientFilterDupTable.h"
+#include "MqttsnClientFilterFragmenter.h"
+#include "MqttsnClientFilterFramer.h"
+#include "MqttsnClientFilterLastValueCache.h"
+#include "MqttsnClientFilterProbe.h"
+#include "MqttsnClientFilterRttEstimator.h"
+#include "MqttsnClientFilterSessionStore.h"
+#include "MqttsnClientFilterSpillLog.h"
+#include "MqttsnClientFilterTopicStats.h"
+#include "MqttsnClientFilterTopicTemplate.h"
+#include "MqttsnClientFilterTopicTrie.h"
+
 #include <cc_tools_qt/Filter.h>
 #include <cc_tools_qt/version.h>
 
@@ -27,10 +42,18 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
 
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iosfwd>
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 static_assert(CC_MQTTSN_CLIENT_MAKE_VERSION(2, 0, 4) <= CC_MQTTSN_CLIENT_VERSION, "The version of the cc_mqttsn_client library is too old");
 static_assert(CC_TOOLS_QT_MAKE_VERSION(5, 3, 3) <= CC_TOOLS_QT_VERSION, "The version of the cc_tools_qt library is too old");
@@ -53,17 +76,156 @@ public:
     // erase the element mustn't invalidate references to other elements, using list.
     using SubConfigsList = std::list<SubConfig>; 
 
+    struct LaneConfig
+    {
+        QString m_topics; // comma separated topic filters
+        unsigned m_weight = 1U;
+    };
+
+    using LaneConfigsList = std::list<LaneConfig>;
+
+    struct LaneStats
+    {
+        std::size_t m_depth = 0U;
+        unsigned long long m_dispatched = 0U;
+        unsigned long long m_totalLatencyUs = 0U;
+        unsigned long long m_maxLatencyUs = 0U;
+    };
+
+    using LaneStatsList = std::vector<LaneStats>;
+
+    struct RttInfo
+    {
+        double m_srttMs = 0.0;
+        double m_rttVarMs = 0.0;
+        double m_lastSampleMs = 0.0;
+        unsigned m_samples = 0U;
+        unsigned m_retryPeriod = 0U;
+    };
+
+    struct PerfSnapshot
+    {
+        qint64 m_timestampUs = 0;
+        CC_MqttsnConnectionStatus m_connectionStatus = CC_MqttsnConnectionStatus_Disconnected;
+        bool m_socketConnected = false;
+        unsigned long long m_published = 0U;
+        unsigned long long m_received = 0U;
+        unsigned long long m_retransmits = 0U;
+        unsigned long long m_timeouts = 0U;
+        std::size_t m_inFlight = 0U;
+        std::size_t m_pending = 0U;
+        double m_srttMs = 0.0;
+        double m_lastRttMs = 0.0;
+        unsigned long long m_poolHits = 0U;
+        unsigned long long m_poolMisses = 0U;
+    };
+
+    enum RxLimitMode
+    {
+        RxLimitMode_PassThrough,
+        RxLimitMode_DropAboveRate,
+        RxLimitMode_LatestValue,
+        RxLimitMode_ValuesLimit
+    };
+
+    struct RxLimitConfig
+    {
+        QString m_topics; // comma separated topic filters
+        int m_mode = RxLimitMode_PassThrough;
+        unsigned m_rate = 0U; // messages per second
+        unsigned m_interval = 1000U; // ms
+    };
+
+    using RxLimitConfigsList = std::list<RxLimitConfig>;
+
+    struct PubRuleConfig
+    {
+        QString m_topics; // comma separated topic filters
+        int m_qos = -1; // -1 means not overridden
+        int m_retain = -1; // -1 means not overridden
+        int m_priority = -1; // -1 means not overridden
+        unsigned m_ttl = 0U; // ms, 0 means never expires
+    };
+
+    using PubRuleConfigsList = std::list<PubRuleConfig>;
+
+    struct RxLimitStats
+    {
+        QString m_topic;
+        unsigned long long m_passed = 0U;
+        unsigned long long m_dropped = 0U;
+    };
+
+    using RxLimitStatsList = std::vector<RxLimitStats>;
+
+    struct CompressStats
+    {
+        unsigned long long m_compressed = 0U;
+        unsigned long long m_skipped = 0U;
+        unsigned long long m_bytesIn = 0U;
+        unsigned long long m_bytesOut = 0U;
+        unsigned long long m_cpuUs = 0U;
+    };
+
+    struct DedupStats
+    {
+        QString m_topic;
+        unsigned long long m_sent = 0U;
+        unsigned long long m_suppressed = 0U;
+    };
+
+    using DedupStatsList = std::vector<DedupStats>;
+
     struct Config
     {
         unsigned m_retryPeriod = 0U;
         unsigned m_retryCount = 0U;
         QString m_clientId;
-        QString m_pubTopic;
+        QString m_pubTopic; // may contain "{prop}" placeholders
         unsigned m_pubTopicId = 0U;
         int m_pubQos = 0;
         SubConfigsList m_subscribes;
         unsigned m_keepAlive = 60;
         bool m_forcedCleanSession = false;
+        QString m_sessionFile;
+        QString m_spillDir;
+        unsigned m_spillThreshold = 1000U;
+        QString m_captureFile;
+        bool m_streamFraming = false; // split the incoming byte stream into frames
+        LaneConfigsList m_lanes;
+        unsigned m_pubMaxInFlight = 0U;
+        unsigned m_pubRate = 0U; // messages per second, 0 means unlimited
+        unsigned m_pubBurst = 1U;
+        unsigned m_topicPubRate = 0U; // messages per second per topic, 0 means unlimited
+        QString m_coalesceTopics; // comma separated topic filters
+        unsigned m_coalesceWindow = 100U;
+        unsigned m_coalesceMaxSize = 200U;
+        unsigned m_fragmentSize = 0U; // 0 means no fragmentation
+        unsigned m_fragmentWindow = 4U;
+        unsigned m_reassemblyMaxSize = 16U * 1024U * 1024U; // single message
+        unsigned m_reassemblyMaxTotal = 64U * 1024U * 1024U; // all incomplete messages
+        unsigned m_reassemblyTimeout = 30000U;
+        QString m_reassemblyTopics; // comma separated topic filters, empty means no reassembly
+        QString m_compressTopics; // comma separated topic filters
+        int m_compressLevel = -1; // zlib default
+        unsigned m_compressMinSize = 64U;
+        QString m_dedupTopics; // comma separated topic filters
+        unsigned m_dedupHeartbeat = 0U; // seconds, 0 means never forced
+        double m_dedupDeadband = 0.0;
+        unsigned m_rxDedupWindow = 0U; // ms, 0 means disabled
+        QString m_rxDedupTopics; // comma separated topic filters, empty means disabled
+        QString m_rxExcludeTopics; // comma separated topic filters
+        unsigned m_lastValueCacheSize = 0U; // bytes, 0 means disabled
+        unsigned m_lastValueMaxEntrySize = 4096U; // bytes, 0 means unlimited
+        unsigned m_topicStatsLimit = 1024U; // topics, 0 means disabled
+        QString m_probeTopic; // empty means disabled
+        unsigned m_probeInterval = 1000U; // ms
+        int m_probeQos = 0;
+        RxLimitConfigsList m_rxLimits;
+        PubRuleConfigsList m_pubRules;
+        bool m_adaptiveRetry = false;
+        unsigned m_minRetryPeriod = 100U;
+        unsigned m_maxRetryPeriod = 10000U;
     };
 
     MqttsnClientFilter();
@@ -77,11 +239,93 @@ public:
     void forceCleanSession()
     {
         m_firstConnect = true;
+        m_cleanSessionForced = true;
+    }
+
+    void subscribesUpdated()
+    {
+        m_topicTrieDirty = true;
+    }
+
+    // The debug output is printed to the standard output by default
+    void setDebugOutputStream(std::ostream& out)
+    {
+        m_debugOut = &out;
+    }
+
+    // Processes multiple received buffers in a single call, such as the
+    // datagrams drained from the socket. All the reported messages get the
+    // extra properties of the first buffer.
+    QList<cc_tools_qt::DataInfoPtr> recvDataBatch(const QList<cc_tools_qt::DataInfoPtr>& batch);
+
+    bool importSubscribes(const QString& path);
+    bool exportSubscribes(const QString& path);
+
+    LaneStatsList laneStats() const;
+    RttInfo rttInfo() const;
+    PerfSnapshot perfSnapshot() const;
+
+    double shaperScale() const
+    {
+        return m_shaperScale;
+    }
+
+    const CompressStats& compressStats() const
+    {
+        return m_compressStats;
+    }
+
+    DedupStatsList dedupStats() const;
+
+    unsigned long long rxDuplicates() const
+    {
+        return m_rxDuplicates;
+    }
+
+    RxLimitStatsList rxLimitStats() const;
+
+    unsigned long long rxExcluded() const
+    {
+        return m_rxExcluded;
+    }
+
+    unsigned long long pubExpired() const
+    {
+        return m_pubExpired;
+    }
+
+    const MqttsnClientFilterLastValueCache::EntriesList& lastValues() const
+    {
+        return m_lastValues.entries();
+    }
+
+    const MqttsnClientFilterTopicStats& topicStats() const
+    {
+        return m_topicStats;
+    }
+
+    void clearTopicStats()
+    {
+        m_topicStats.clear();
+    }
+
+    bool exportTopicStats(const QString& path);
+
+    MqttsnClientFilterProbe::Stats probeStats() const
+    {
+        return m_probe.stats();
     }
 
 signals:
     void sigConfigChanged();    
 
+    // Reports the held latest values flushed by the timer when no data
+    // is received. The cc_tools_qt filter interface cannot deliver the
+    // received data outside of recvData(), without the connected receiver
+    // the timer doesn't flush and the held values are reported with the 
+    // next received frame.
+    void sigDataReceived(QList<cc_tools_qt::DataInfoPtr> data);
+
 protected:
     virtual bool startImpl() override;
     virtual void stopImpl() override;
@@ -93,6 +337,12 @@ protected:
 
 private slots:
     void doTick();
+    void doSpillReplay();
+    void doDispatch();
+    void doCoalesceFlush();
+    void doFragmentRelease();
+    void doProbe();
+    void doRxFlush();
 
 private:
     struct ClientDeleter
@@ -105,9 +355,179 @@ private:
     
     using ClientPtr = std::unique_ptr<CC_MqttsnClient, ClientDeleter>;
 
+    struct SubscribeOp
+    {
+        MqttsnClientFilter* m_filter = nullptr;
+        std::string m_topic;
+        unsigned m_topicId = 0U;
+        int m_qos = 0;
+        qint64 m_startTsUs = 0;
+        unsigned m_retryPeriod = 0U;
+    };
+
+    using SubscribeOpPtr = std::unique_ptr<SubscribeOp>;
+    using SubscribeOpsMap = std::map<const SubscribeOp*, SubscribeOpPtr>;
+
+    struct PublishOp
+    {
+        MqttsnClientFilter* m_filter = nullptr;
+        MqttsnClientFilterSpillLog::SegmentId m_spillSegment = 0U;
+        qint64 m_startTsUs = 0;
+        unsigned m_retryPeriod = 0U;
+        unsigned m_roundTrips = 0U;
+        cc_tools_qt::DataInfoPtr m_dataPtr;
+        unsigned m_lane = 0U;
+        const cc_tools_qt::DataInfo* m_fragment = nullptr;
+        unsigned long long m_spillSeq = 0U;
+        unsigned m_spillAttempts = 0U;
+        bool m_spilled = false;
+        bool m_spillRetry = false;
+    };
+
+    using PublishOpPtr = std::unique_ptr<PublishOp>;
+    using PublishOpsMap = std::map<const PublishOp*, PublishOpPtr>;
+
+    struct SpillRetry
+    {
+        cc_tools_qt::DataInfoPtr m_dataPtr;
+        MqttsnClientFilterSpillLog::SegmentId m_segment = 0U;
+        unsigned long long m_seq = 0U;
+        unsigned m_attempts = 0U;
+    };
+
+    using SpillRetriesList = std::deque<SpillRetry>;
+
+    struct QueuedData
+    {
+        cc_tools_qt::DataInfoPtr m_dataPtr;
+        std::string m_topicKey;
+        qint64 m_enqueueTsUs = 0;
+    };
+
+    struct Lane
+    {
+        std::vector<std::string> m_topics;
+        std::deque<QueuedData> m_queue;
+        unsigned m_weight = 1U;
+        unsigned m_credit = 0U;
+        LaneStats m_stats;
+    };
+
+    using LanesList = std::vector<Lane>;
+
+    struct TokenBucket
+    {
+        double m_tokens = 0.0;
+        qint64 m_lastTsUs = 0;
+    };
+
+    using TopicBucketsMap = std::map<std::string, TokenBucket>;
+
+    struct DedupEntry
+    {
+        std::uint64_t m_hash = 0U;
+        double m_value = 0.0;
+        qint64 m_lastSentUs = 0;
+        unsigned long long m_sent = 0U;
+        unsigned long long m_suppressed = 0U;
+        bool m_numeric = false;
+    };
+
+    using DedupEntriesMap = std::map<std::string, DedupEntry>;
+
+    struct RxLimitRule
+    {
+        std::vector<std::string> m_topics;
+        int m_mode = RxLimitMode_PassThrough;
+        unsigned m_rate = 0U;
+        qint64 m_intervalUs = 0;
+    };
+
+    using RxLimitRulesList = std::vector<RxLimitRule>;
+
+    struct PubRule
+    {
+        std::vector<std::string> m_topics;
+        int m_qos = -1;
+        int m_retain = -1;
+        int m_priority = -1;
+        unsigned m_ttl = 0U;
+    };
+
+    using PubRulesList = std::vector<PubRule>;
+
+    struct RxTopicState
+    {
+        int m_rule = -1;
+        qint64 m_windowStartUs = 0;
+        unsigned m_windowCount = 0U;
+        std::vector<std::uint8_t> m_latest;
+        qint64 m_lastFlushUs = 0;
+        int m_qos = 0;
+        int m_subIdx = -1;
+        bool m_retained = false;
+        bool m_pending = false;
+        unsigned long long m_passed = 0U;
+        unsigned long long m_dropped = 0U;
+    };
+
+    // Transparent comparator allows lookup by the C string without allocation
+    using RxTopicStatesMap = std::map<std::string, RxTopicState, std::less<>>;
+
     void socketConnected();
     void socketDisconnected();
+    std::ostream& debugOut() const
+    {
+        return *m_debugOut;
+    }
+
+    void processRecvDataInternal();
+    void processFrameInternal(const std::uint8_t* frame, std::size_t frameLen);
     void sendPendingData();
+    void pendDataInternal(cc_tools_qt::DataInfoPtr dataPtr);
+    void submitDataInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic);
+    bool coalesceInternal(cc_tools_qt::DataInfoPtr& dataPtr, const std::string& topic);
+    void submitCoalescedInternal(MqttsnClientFilterCoalescer::DataInfosList& ready);
+    void programCoalesceFlush();
+    void releaseFragmentsInternal();
+    cc_tools_qt::DataInfoPtr compressInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic);
+    bool suppressInternal(const cc_tools_qt::DataInfo& info, const std::string& topic);
+    void applyRxLimitsConfig();
+    void applyPubRulesConfig();
+    void applyPubRuleInternal(QVariantMap& props, const std::string& topic);
+    bool pubExpiredInternal(const QVariantMap& props) const;
+    bool rxLimitInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx);
+    void flushLatestValuesInternal();
+    void reportReceivedInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx);
+    void appendReceivedInternal(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained, int subIdx);
+    void syncTopicTrie();
+    bool outgoingTopicInternal(const QVariantMap& props, std::string& topic);
+    std::string outgoingTopicKeyInternal(const QVariantMap& props, const std::string& topic);
+    void reportLastValuesInternal();
+    bool matchTopicTrie(const char* topic, int& subIdx) const;
+    void applyLanesConfig();
+    bool lanesActive() const;
+    void sendOrQueueInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic);
+    void enqueueLaneInternal(cc_tools_qt::DataInfoPtr dataPtr, const std::string& topic);
+    void requeueLaneInternal(cc_tools_qt::DataInfoPtr dataPtr, unsigned laneIdx);
+    void dispatchLanes();
+    int selectLane(const std::vector<bool>& blocked);
+    bool shaperActive() const;
+    qint64 shaperWaitUs(TokenBucket& bucket, unsigned rate, qint64 nowUs) const;
+    void shaperBackoff();
+    void shaperRecover();
+    bool publishInternal(cc_tools_qt::DataInfoPtr dataPtr, PublishOpPtr opPtr = PublishOpPtr());
+    void publishOpComplete(const PublishOp& op, bool retry = false, bool timeout = false);
+    bool spillActiveInternal() const;
+    void captureFailedInternal();
+    void reportCollectedSendData();
+    void loadSessionState();
+    void resetSessionState();
+    void subscribeInternal(const SubConfig& sub);
+    void rttSampleInternal(qint64 startTsUs, unsigned retryPeriod, unsigned roundTrips);
+    void rttBackoffInternal();
+    void applyRetryPeriod(unsigned period);
+    void startProbeInternal();
 
     void sendDataInternal(const unsigned char* buf, unsigned bufLen, unsigned broadcastRadius);
     void gwDisconnectedInternal(CC_MqttsnGatewayDisconnectReason reason);
@@ -115,8 +535,9 @@ private:
     void nextTickProgramInternal(unsigned ms);
     unsigned cancelTickProgramInternal();
     void connectCompleteInternal(CC_MqttsnAsyncOpStatus status, const CC_MqttsnConnectInfo* info);
-    void subscribeCompleteInternal(CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info);
-    void publishCompleteInternal(CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info);
+    void subscribeCompleteInternal(const SubscribeOp& op, CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info);
+    void publishCompleteInternal(const PublishOp& op, CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info);
+    void probePublishCompleteInternal(CC_MqttsnAsyncOpStatus status);
     
 
     static void sendDataCb(void* data, const unsigned char* buf, unsigned bufLen, unsigned broadcastRadius);
@@ -129,19 +550,90 @@ private:
     static void disconnectCompleteCb(void* data, CC_MqttsnAsyncOpStatus status);
     static void subscribeCompleteCb(void* data, CC_MqttsnSubscribeHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnSubscribeInfo* info);
     static void publishCompleteCb(void* data, CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info);
+    static void probePublishCompleteCb(void* data, CC_MqttsnPublishHandle handle, CC_MqttsnAsyncOpStatus status, const CC_MqttsnPublishInfo* info);
 
     ClientPtr m_client;
+    MqttsnClientFilterDataInfoPool m_dataInfoPool;
     QTimer m_timer;
     std::list<cc_tools_qt::DataInfoPtr> m_pendingData;
     Config m_config;
     std::string m_prevClientId;
+    MqttsnClientFilterSessionStore m_sessionStore;
+    SubscribeOpsMap m_subscribeOps;
+    PublishOpsMap m_publishOps;
+    MqttsnClientFilterSpillLog m_spillLog;
+    QTimer m_spillTimer;
+    unsigned m_spillInFlight = 0U;
+    SpillRetriesList m_spillRetries;
+    unsigned m_spillRetriesInFlight = 0U;
+    unsigned long long m_nextSpillSeq = 0U;
+    LanesList m_lanes;
+    QTimer m_dispatchTimer;
+    TokenBucket m_pubBucket;
+    TopicBucketsMap m_topicBuckets;
+    double m_shaperScale = 1.0;
+    MqttsnClientFilterCoalescer m_coalescer;
+    std::vector<std::string> m_coalesceFilters;
+    QTimer m_coalesceTimer;
+    MqttsnClientFilterCoalescer::RecordsList m_coalescedRecords;
+    MqttsnClientFilterFragmenter m_fragmenter;
+    std::map<const cc_tools_qt::DataInfo*, cc_tools_qt::DataInfoPtr> m_fragmentsInFlight;
+    QTimer m_fragmentTimer;
+    MqttsnClientFilterFragmenter::DataBuf m_reassembled;
+    std::vector<std::string> m_reassemblyFilters;
+    std::vector<std::string> m_compressFilters;
+    CompressStats m_compressStats;
+    QByteArray m_decompressed;
+    std::vector<std::string> m_dedupFilters;
+    DedupEntriesMap m_dedupEntries;
+    std::vector<std::string> m_rxDedupFilters;
+    MqttsnClientFilterDupTable m_rxDupTable;
+    unsigned long long m_rxDuplicates = 0U;
+    RxLimitRulesList m_rxLimitRules;
+    RxTopicStatesMap m_rxTopicStates;
+    QTimer m_rxFlushTimer;
+    MqttsnClientFilterTopicTrie m_topicTrie;
+    std::map<std::string, int> m_trieSubValues; // subscription topic -> trie value
+    std::vector<int> m_trieSubIndices; // trie value -> subscription index, -1 when unused
+    std::vector<std::string> m_trieExcludes;
+    std::vector<QString> m_subTopics;
+    bool m_topicTrieDirty = true;
+    unsigned long long m_rxExcluded = 0U;
+    MqttsnClientFilterLastValueCache m_lastValues;
+    MqttsnClientFilterTopicStats m_topicStats;
+    MqttsnClientFilterCapture m_capture;
+    MqttsnClientFilterFramer m_framer;
+    MqttsnClientFilterProbe m_probe;
+    std::string m_probeTopic;
+    MqttsnClientFilterProbe::DataBuf m_probeData;
+    QTimer m_probeTimer;
+    MqttsnClientFilterTopicTemplate m_pubTopicTemplate;
+    std::string m_sendTopic;
+    PubRulesList m_pubRules;
+    std::map<std::string, int, std::less<>> m_pubRuleCache;
+    bool m_pubRulesTtl = false;
+    unsigned long long m_pubExpired = 0U;
+    MqttsnClientFilterRttEstimator m_rtt;
+    unsigned m_currRetryPeriod = 0U;
+    qint64 m_rttTuneTsUs = 0;
+    qint64 m_connectTsUs = 0;
+    unsigned m_connectRetryPeriod = 0U;
+    unsigned long long m_published = 0U;
+    unsigned long long m_received = 0U;
+    unsigned long long m_retransmits = 0U;
+    unsigned long long m_timeouts = 0U;
+    std::set<std::string> m_registeredTopics;
     unsigned m_tickMs = 0U;
     qint64 m_tickMeasureTs = 0;
     cc_tools_qt::DataInfoPtr m_recvDataPtr;
+    QVariantMap m_recvProps;
+    bool m_rxFrameDup = false;
+    std::ostream* m_debugOut = nullptr; // never null after construction
     QList<cc_tools_qt::DataInfoPtr> m_recvData;
     cc_tools_qt::DataInfoPtr m_sendDataPtr;
     QList<cc_tools_qt::DataInfoPtr> m_sendData;
     bool m_firstConnect = true;
+    bool m_cleanSessionForced = false;
     bool m_socketConnected = false;
     bool m_cleanSession = false;
 };
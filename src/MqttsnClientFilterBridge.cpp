@@ -0,0 +1,335 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterBridge.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const qint64 ReadChunkSize = 64 * 1024;
+const int OutputFlushSize = 64 * 1024;
+const int SocketBufferSize = 4 * 1024 * 1024;
+const int MaxRecvBatch = 256;
+const unsigned TopicLenFieldLen = 2U;
+const unsigned DataLenFieldLen = 4U;
+
+const QString& topicProp()
+{
+    static const QString Str("mqttsn.topic");
+    return Str;
+}
+
+unsigned readU16(const char* data)
+{
+    return
+        (static_cast<unsigned>(static_cast<std::uint8_t>(data[0])) << 8U) |
+        static_cast<unsigned>(static_cast<std::uint8_t>(data[1]));
+}
+
+unsigned readU32(const char* data)
+{
+    return
+        (static_cast<unsigned>(static_cast<std::uint8_t>(data[0])) << 24U) |
+        (static_cast<unsigned>(static_cast<std::uint8_t>(data[1])) << 16U) |
+        (static_cast<unsigned>(static_cast<std::uint8_t>(data[2])) << 8U) |
+        static_cast<unsigned>(static_cast<std::uint8_t>(data[3]));
+}
+
+void appendU16(unsigned value, QByteArray& out)
+{
+    out.append(static_cast<char>((value >> 8U) & 0xff));
+    out.append(static_cast<char>(value & 0xff));
+}
+
+void appendU32(unsigned value, QByteArray& out)
+{
+    out.append(static_cast<char>((value >> 24U) & 0xff));
+    out.append(static_cast<char>((value >> 16U) & 0xff));
+    out.append(static_cast<char>((value >> 8U) & 0xff));
+    out.append(static_cast<char>(value & 0xff));
+}
+
+} // namespace
+
+MqttsnClientFilterBridge::MqttsnClientFilterBridge(MqttsnClientFilter& filter, QObject* parentObj) :
+    QObject(parentObj),
+    m_filter(filter)
+{
+    m_outBuf.reserve(OutputFlushSize * 2);
+}
+
+MqttsnClientFilterBridge::~MqttsnClientFilterBridge() noexcept
+{
+    flushOutput();
+}
+
+bool MqttsnClientFilterBridge::start(const Options& options)
+{
+    if (!m_gatewayAddr.setAddress(options.m_gatewayHost)) {
+        std::cerr << "ERROR: Invalid gateway address: " << options.m_gatewayHost.toStdString() << std::endl;
+        return false;
+    }
+
+    m_gatewayPort = options.m_gatewayPort;
+    if (!m_socket.bind(QHostAddress(QHostAddress::AnyIPv4), options.m_localPort)) {
+        std::cerr << "ERROR: Failed to bind UDP socket: " << m_socket.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    m_socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, SocketBufferSize);
+    m_socket.setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, SocketBufferSize);
+
+    connect(
+        &m_socket, &QUdpSocket::readyRead,
+        this, &MqttsnClientFilterBridge::gatewayReadyRead);
+
+    m_filter.setDataToSendCallback(
+        [this](cc_tools_qt::DataInfoPtr dataPtr)
+        {
+            assert(dataPtr);
+            sendToGateway(*dataPtr);
+        });
+
+    connect(
+        &m_filter, &MqttsnClientFilter::sigDataReceived,
+        this,
+        [this](QList<cc_tools_qt::DataInfoPtr> data)
+        {
+            for (auto& msgPtr : data) {
+                writeOutput(*msgPtr);
+            }
+            flushOutput();
+        });
+
+    if (!m_filter.start()) {
+        std::cerr << "ERROR: Failed to start the MQTT-SN client" << std::endl;
+        return false;
+    }
+
+    m_filter.socketConnectionReport(true);
+
+    if (options.m_localSocket.isEmpty()) {
+        m_stdinNotifier = std::make_unique<QSocketNotifier>(STDIN_FILENO, QSocketNotifier::Read);
+        connect(
+            m_stdinNotifier.get(), &QSocketNotifier::activated,
+            this, &MqttsnClientFilterBridge::stdinReadyRead);
+        return true;
+    }
+
+    // Stale socket file of the previous run prevents listening
+    QLocalServer::removeServer(options.m_localSocket);
+    if (!m_localServer.listen(options.m_localSocket)) {
+        std::cerr << "ERROR: Failed to listen on " << options.m_localSocket.toStdString() << ": " << 
+            m_localServer.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    connect(
+        &m_localServer, &QLocalServer::newConnection,
+        this, &MqttsnClientFilterBridge::newLocalConnection);
+
+    return true;
+}
+
+void MqttsnClientFilterBridge::stdinReadyRead()
+{
+    auto prevSize = m_stdinBuf.size();
+    m_stdinBuf.resize(prevSize + static_cast<int>(ReadChunkSize));
+    ssize_t count = 0;
+    do {
+        count = ::read(STDIN_FILENO, m_stdinBuf.data() + prevSize, static_cast<std::size_t>(ReadChunkSize));
+    } while ((count < 0) && (errno == EINTR));
+
+    if (count < 0) {
+        // Nothing to read yet, wait for the next notification
+        m_stdinBuf.resize(prevSize);
+        return;
+    }
+
+    if (count == 0) {
+        // The end of input, keep reporting the received messages
+        m_stdinBuf.resize(prevSize);
+        m_stdinNotifier->setEnabled(false);
+        return;
+    }
+
+    m_stdinBuf.resize(prevSize + static_cast<int>(count));
+    processInput(m_stdinBuf);
+}
+
+void MqttsnClientFilterBridge::newLocalConnection()
+{
+    while (m_localServer.hasPendingConnections()) {
+        auto* socket = m_localServer.nextPendingConnection();
+        m_localBufs[socket];
+
+        connect(
+            socket, &QLocalSocket::readyRead,
+            this, &MqttsnClientFilterBridge::localReadyRead);
+
+        connect(
+            socket, &QLocalSocket::disconnected,
+            this, &MqttsnClientFilterBridge::localDisconnected);
+    }
+}
+
+void MqttsnClientFilterBridge::localReadyRead()
+{
+    auto* socket = qobject_cast<QLocalSocket*>(sender());
+    auto iter = m_localBufs.find(socket);
+    if (iter == m_localBufs.end()) {
+        return;
+    }
+
+    auto& buf = iter->second;
+    buf.append(socket->readAll());
+    processInput(buf);
+}
+
+void MqttsnClientFilterBridge::localDisconnected()
+{
+    auto* socket = qobject_cast<QLocalSocket*>(sender());
+    m_localBufs.erase(socket);
+    socket->deleteLater();
+}
+
+void MqttsnClientFilterBridge::gatewayReadyRead()
+{
+    while (m_socket.hasPendingDatagrams()) {
+        auto size = m_socket.pendingDatagramSize();
+        if (size < 0) {
+            break;
+        }
+
+        m_recvBuf.resize(static_cast<int>(size));
+        auto count = m_socket.readDatagram(m_recvBuf.data(), size);
+        if (count <= 0) {
+            continue;
+        }
+
+        auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+        dataPtr->m_data.assign(m_recvBuf.constData(), m_recvBuf.constData() + count);
+        m_recvBatch.append(std::move(dataPtr));
+        if (MaxRecvBatch <= m_recvBatch.size()) {
+            processRecvBatch();
+        }
+    }
+
+    processRecvBatch();
+    flushOutput();
+}
+
+void MqttsnClientFilterBridge::processRecvBatch()
+{
+    if (m_recvBatch.isEmpty()) {
+        return;
+    }
+
+    auto received = m_filter.recvDataBatch(m_recvBatch);
+    m_recvBatch.clear();
+    for (auto& msgPtr : received) {
+        writeOutput(*msgPtr);
+    }
+}
+
+void MqttsnClientFilterBridge::processInput(QByteArray& buf)
+{
+    auto* data = buf.constData();
+    auto remLen = static_cast<unsigned>(buf.size());
+    unsigned pos = 0U;
+    while (TopicLenFieldLen <= (remLen - pos)) {
+        auto topicLen = readU16(data + pos);
+        auto dataLenPos = pos + TopicLenFieldLen + topicLen;
+        if ((remLen < dataLenPos) || ((remLen - dataLenPos) < DataLenFieldLen)) {
+            break;
+        }
+
+        auto dataLen = readU32(data + dataLenPos);
+        auto dataPos = dataLenPos + DataLenFieldLen;
+        if ((remLen - dataPos) < dataLen) {
+            break;
+        }
+
+        publishInternal(data + pos + TopicLenFieldLen, topicLen, data + dataPos, dataLen);
+        pos = dataPos + dataLen;
+    }
+
+    // Keep the incomplete record till more data arrives
+    buf.remove(0, static_cast<int>(pos));
+}
+
+void MqttsnClientFilterBridge::publishInternal(const char* topic, unsigned topicLen, const char* data, unsigned dataLen)
+{
+    auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+    dataPtr->m_data.assign(data, data + dataLen);
+    if (0U < topicLen) {
+        dataPtr->m_extraProperties[topicProp()] = QString::fromUtf8(topic, static_cast<int>(topicLen));
+    }
+
+    auto toSend = m_filter.sendData(std::move(dataPtr));
+    for (auto& sendPtr : toSend) {
+        sendToGateway(*sendPtr);
+    }
+}
+
+void MqttsnClientFilterBridge::sendToGateway(const cc_tools_qt::DataInfo& info)
+{
+    m_socket.writeDatagram(
+        reinterpret_cast<const char*>(info.m_data.data()), static_cast<qint64>(info.m_data.size()), 
+        m_gatewayAddr, m_gatewayPort);
+}
+
+void MqttsnClientFilterBridge::writeOutput(const cc_tools_qt::DataInfo& info)
+{
+    auto topic = info.m_extraProperties.value(topicProp()).toString().toUtf8();
+    appendU16(static_cast<unsigned>(topic.size()), m_outBuf);
+    m_outBuf.append(topic);
+    appendU32(static_cast<unsigned>(info.m_data.size()), m_outBuf);
+    m_outBuf.append(reinterpret_cast<const char*>(info.m_data.data()), static_cast<int>(info.m_data.size()));
+
+    if (OutputFlushSize <= m_outBuf.size()) {
+        flushOutput();
+    }
+}
+
+void MqttsnClientFilterBridge::flushOutput()
+{
+    if (m_outBuf.isEmpty()) {
+        return;
+    }
+
+    std::fwrite(m_outBuf.constData(), 1U, static_cast<std::size_t>(m_outBuf.size()), stdout);
+    std::fflush(stdout);
+
+    // Keeps the allocated capacity
+    m_outBuf.resize(0);
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
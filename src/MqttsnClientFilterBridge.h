@@ -0,0 +1,94 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QString>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+#include <QtNetwork/QUdpSocket>
+
+#include <map>
+#include <memory>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Hosts the filter without the GUI. The payloads to publish are read from
+// the standard input or from the clients of the local (Unix domain) socket,
+// the MQTT-SN traffic is exchanged with the gateway over UDP, and the received
+// application messages are written to the standard output.
+//
+// Both the input and the output use the same record format (big endian):
+//     u16 topic length | topic | u32 payload length | payload
+// The empty topic of the input record selects the configured publish topic.
+class MqttsnClientFilterBridge : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString m_gatewayHost = "127.0.0.1";
+        quint16 m_gatewayPort = 1883U;
+        quint16 m_localPort = 0U;
+        QString m_localSocket; // empty means standard input
+    };
+
+    explicit MqttsnClientFilterBridge(MqttsnClientFilter& filter, QObject* parentObj = nullptr);
+    ~MqttsnClientFilterBridge() noexcept;
+
+    bool start(const Options& options);
+
+private slots:
+    void stdinReadyRead();
+    void newLocalConnection();
+    void localReadyRead();
+    void localDisconnected();
+    void gatewayReadyRead();
+
+private:
+    void processRecvBatch();
+    void processInput(QByteArray& buf);
+    void publishInternal(const char* topic, unsigned topicLen, const char* data, unsigned dataLen);
+    void sendToGateway(const cc_tools_qt::DataInfo& info);
+    void writeOutput(const cc_tools_qt::DataInfo& info);
+    void flushOutput();
+
+    MqttsnClientFilter& m_filter;
+    QUdpSocket m_socket;
+    QHostAddress m_gatewayAddr;
+    quint16 m_gatewayPort = 0U;
+    std::unique_ptr<QSocketNotifier> m_stdinNotifier;
+    QLocalServer m_localServer;
+    std::map<QLocalSocket*, QByteArray> m_localBufs;
+    QByteArray m_stdinBuf;
+    QByteArray m_recvBuf;
+    QList<cc_tools_qt::DataInfoPtr> m_recvBatch;
+    QByteArray m_outBuf;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,157 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilter.h"
+#include "MqttsnClientFilterBridge.h"
+#include "MqttsnClientFilterConfigIo.h"
+#include "MqttsnClientFilterReplay.h"
+
+#include <QtCore/QCommandLineOption>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonParseError>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+
+const QString ConfigOpt("config");
+const QString GatewayOpt("gateway");
+const QString PortOpt("port");
+const QString LocalPortOpt("local-port");
+const QString UnixSocketOpt("unix-socket");
+const QString DebugOpt("debug");
+const QString ReplayOpt("replay");
+const QString SpeedOpt("speed");
+
+bool loadConfig(const QString& path, cc_plugin_mqttsn_client_filter::MqttsnClientFilter::Config& cfg)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "ERROR: Failed to open " << path.toStdString() << ": " << file.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    QJsonParseError parseError;
+    auto doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        std::cerr << "ERROR: Invalid configuration file " << path.toStdString() << ": " << parseError.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    if (!cc_plugin_mqttsn_client_filter::MqttsnClientFilterConfigIo::loadConfig(doc.object().toVariantMap(), cfg)) {
+        std::cerr << "ERROR: No MQTT-SN client filter configuration in " << path.toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void printReplayReport(const cc_plugin_mqttsn_client_filter::MqttsnClientFilterReplay::Report& report)
+{
+    auto elapsedSec = static_cast<double>(std::max(report.m_elapsedUs, qint64(1))) / 1000000.0;
+    auto busySec = static_cast<double>(std::max(report.m_busyUs, qint64(1))) / 1000000.0;
+    auto records = report.m_inFrames + report.m_publishes;
+    std::cerr << 
+        "Replayed " << report.m_inFrames << " received frames and " << report.m_publishes << " publishes (" << 
+            report.m_bytes << " bytes) in " << elapsedSec << " sec\n" <<
+        "Throughput: " << static_cast<double>(records) / elapsedSec << " records/sec, " << 
+            static_cast<double>(records) / busySec << " records/sec of filter time\n" <<
+        "Delivered messages: " << report.m_delivered << "\n" <<
+        "Sent frames: " << report.m_outFrames << " (" << report.m_matched << " matched, " << 
+            report.m_mismatched << " mismatched, " << report.m_missing << " missing, " << 
+            report.m_extra << " extra)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cc_mqttsn_client_filter_bridge");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless MQTT-SN client bridge. Publishes the records read from the standard input "
+        "(or the local socket) and writes the received messages to the standard output. "
+        "Record format (big endian): u16 topic length | topic | u32 payload length | payload.");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption(QStringList{"c", ConfigOpt}, "Configuration file saved by the CommsChampion Tools.", "file"));
+    parser.addOption(QCommandLineOption(QStringList{"g", GatewayOpt}, "Gateway address.", "address", "127.0.0.1"));
+    parser.addOption(QCommandLineOption(QStringList{"p", PortOpt}, "Gateway UDP port.", "port", "1883"));
+    parser.addOption(QCommandLineOption(QStringList{"l", LocalPortOpt}, "Local UDP port, 0 means any.", "port", "0"));
+    parser.addOption(QCommandLineOption(QStringList{"u", UnixSocketOpt}, "Read the records from the clients of the local socket instead of the standard input.", "path"));
+    parser.addOption(QCommandLineOption(QStringList{"r", ReplayOpt}, "Replay the capture file through the filter instead of bridging and report the throughput and divergence.", "file"));
+    parser.addOption(QCommandLineOption(QStringList{"s", SpeedOpt}, "Replay speed factor, 0 means as fast as possible.", "factor", "1"));
+    parser.addOption(QCommandLineOption(QStringList{"d", DebugOpt}, "Debug output level, printed to the standard error not to interfere with the received records.", "level", "0"));
+    parser.process(app);
+
+    auto filter = cc_plugin_mqttsn_client_filter::makeMqttsnClientFilter();
+    if (parser.isSet(ConfigOpt) && (!loadConfig(parser.value(ConfigOpt), filter->config()))) {
+        return -1;
+    }
+
+    filter->setDebugOutputLevel(parser.value(DebugOpt).toUInt());
+    filter->setDebugOutputStream(std::cerr);
+    filter->setErrorReportCallback(
+        [](const QString& msg)
+        {
+            std::cerr << "ERROR: " << msg.toStdString() << std::endl;
+        });
+
+    if (parser.isSet(ReplayOpt)) {
+        // The replayed capture must not be overwritten by the new one, and
+        // the live session and spilled data must be neither loaded nor modified
+        filter->config().m_captureFile.clear();
+        filter->config().m_sessionFile.clear();
+        filter->config().m_spillDir.clear();
+
+        cc_plugin_mqttsn_client_filter::MqttsnClientFilterReplay replay(*filter);
+        QObject::connect(
+            &replay, &cc_plugin_mqttsn_client_filter::MqttsnClientFilterReplay::sigFinished,
+            [&replay]()
+            {
+                printReplayReport(replay.report());
+                QCoreApplication::quit();
+            });
+
+        if (!replay.start(parser.value(ReplayOpt), parser.value(SpeedOpt).toDouble())) {
+            std::cerr << "ERROR: Failed to replay " << parser.value(ReplayOpt).toStdString() << std::endl;
+            return -1;
+        }
+
+        return app.exec();
+    }
+
+    cc_plugin_mqttsn_client_filter::MqttsnClientFilterBridge::Options options;
+    options.m_gatewayHost = parser.value(GatewayOpt);
+    options.m_gatewayPort = static_cast<quint16>(parser.value(PortOpt).toUInt());
+    options.m_localPort = static_cast<quint16>(parser.value(LocalPortOpt).toUInt());
+    options.m_localSocket = parser.value(UnixSocketOpt);
+
+    cc_plugin_mqttsn_client_filter::MqttsnClientFilterBridge bridge(*filter);
+    if (!bridge.start(options)) {
+        return -1;
+    }
+
+    return app.exec();
+}
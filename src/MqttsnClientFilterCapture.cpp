@@ -0,0 +1,275 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterCapture.h"
+
+#include <QtCore/QDataStream>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const char Magic[] = {'C', 'C', 'S', 'N', 'C', 'A', 'P', 1};
+const std::size_t MagicLen = std::extent<decltype(Magic)>::value;
+const std::size_t RecordHeaderLen = 13U; // u64 timestamp, u8 direction, u32 length
+const qint64 GrowStep = 4 * 1024 * 1024;
+
+std::uint64_t readU64(const uchar* data)
+{
+    std::uint64_t result = 0U;
+    for (auto idx = 0U; idx < 8U; ++idx) {
+        result = (result << 8U) | static_cast<std::uint64_t>(data[idx]);
+    }
+    return result;
+}
+
+std::uint32_t readU32(const uchar* data)
+{
+    return
+        (static_cast<std::uint32_t>(data[0]) << 24U) |
+        (static_cast<std::uint32_t>(data[1]) << 16U) |
+        (static_cast<std::uint32_t>(data[2]) << 8U) |
+        static_cast<std::uint32_t>(data[3]);
+}
+
+void writeU64(std::uint64_t value, uchar* data)
+{
+    for (auto idx = 0U; idx < 8U; ++idx) {
+        data[7U - idx] = static_cast<uchar>(value & 0xff);
+        value >>= 8U;
+    }
+}
+
+void writeU32(std::uint32_t value, uchar* data)
+{
+    data[0] = static_cast<uchar>((value >> 24U) & 0xff);
+    data[1] = static_cast<uchar>((value >> 16U) & 0xff);
+    data[2] = static_cast<uchar>((value >> 8U) & 0xff);
+    data[3] = static_cast<uchar>(value & 0xff);
+}
+
+} // namespace
+
+MqttsnClientFilterCapture::MqttsnClientFilterCapture() = default;
+
+MqttsnClientFilterCapture::~MqttsnClientFilterCapture() noexcept
+{
+    close();
+}
+
+bool MqttsnClientFilterCapture::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        return false;
+    }
+
+    m_writable = true;
+    m_size = 0;
+    m_capacity = 0;
+    if (!growInternal(MagicLen)) {
+        close();
+        return false;
+    }
+
+    std::copy(std::begin(Magic), std::end(Magic), m_map);
+    m_size = static_cast<qint64>(MagicLen);
+    m_startTs = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool MqttsnClientFilterCapture::load(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_capacity = m_size;
+    if (m_size < static_cast<qint64>(MagicLen)) {
+        close();
+        return false;
+    }
+
+    m_map = m_file.map(0, m_size);
+    if ((m_map == nullptr) || (!std::equal(std::begin(Magic), std::end(Magic), reinterpret_cast<const char*>(m_map)))) {
+        close();
+        return false;
+    }
+
+    m_readPos = static_cast<qint64>(MagicLen);
+    return true;
+}
+
+void MqttsnClientFilterCapture::close()
+{
+    if (m_map != nullptr) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    if (m_file.isOpen()) {
+        if (m_writable) {
+            m_file.resize(m_size);
+        }
+
+        m_file.close();
+    }
+
+    m_writable = false;
+    m_size = 0;
+    m_capacity = 0;
+    m_readPos = 0;
+}
+
+bool MqttsnClientFilterCapture::append(Direction direction, const std::uint8_t* data, std::size_t dataLen)
+{
+    if ((!isOpen()) || (!m_writable)) {
+        return false;
+    }
+
+    auto recLen = RecordHeaderLen + dataLen;
+    if ((m_capacity - m_size) < static_cast<qint64>(recLen)) {
+        if (!growInternal(recLen)) {
+            close();
+            return false;
+        }
+    }
+
+    auto tsUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTs).count();
+    auto* rec = m_map + m_size;
+    writeU64(static_cast<std::uint64_t>(tsUs), rec);
+    rec[8] = static_cast<uchar>(direction);
+    writeU32(static_cast<std::uint32_t>(dataLen), rec + 9);
+    if (0U < dataLen) {
+        std::memcpy(rec + RecordHeaderLen, data, dataLen);
+    }
+
+    m_size += static_cast<qint64>(recLen);
+    return true;
+}
+
+bool MqttsnClientFilterCapture::appendPublish(const cc_tools_qt::DataInfo& info)
+{
+    // u32 properties length | properties | payload
+    m_publishBuf.resize(4);
+    {
+        QDataStream stream(&m_publishBuf, QIODevice::WriteOnly | QIODevice::Append);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream << info.m_extraProperties;
+    }
+
+    writeU32(static_cast<std::uint32_t>(m_publishBuf.size() - 4), reinterpret_cast<uchar*>(m_publishBuf.data()));
+    m_publishBuf.append(reinterpret_cast<const char*>(info.m_data.data()), static_cast<int>(info.m_data.size()));
+    return append(Direction_Publish, reinterpret_cast<const std::uint8_t*>(m_publishBuf.constData()), static_cast<std::size_t>(m_publishBuf.size()));
+}
+
+bool MqttsnClientFilterCapture::readNext(Record& record)
+{
+    if ((!isOpen()) || (m_writable)) {
+        return false;
+    }
+
+    auto remLen = m_size - m_readPos;
+    if (remLen < static_cast<qint64>(RecordHeaderLen)) {
+        return false;
+    }
+
+    auto* rec = m_map + m_readPos;
+    auto direction = rec[8];
+    auto dataLen = static_cast<qint64>(readU32(rec + 9));
+    if ((direction < Direction_In) || (Direction_Publish < direction) ||
+        ((remLen - static_cast<qint64>(RecordHeaderLen)) < dataLen)) {
+        // Unused or truncated tail
+        return false;
+    }
+
+    record.m_timestampUs = static_cast<qint64>(readU64(rec));
+    record.m_direction = static_cast<Direction>(direction);
+    record.m_data = rec + RecordHeaderLen;
+    record.m_dataLen = static_cast<std::size_t>(dataLen);
+    m_readPos += static_cast<qint64>(RecordHeaderLen) + dataLen;
+    return true;
+}
+
+void MqttsnClientFilterCapture::rewind()
+{
+    if (isOpen() && (!m_writable)) {
+        m_readPos = static_cast<qint64>(MagicLen);
+    }
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilterCapture::decodePublish(const Record& record)
+{
+    assert(record.m_direction == Direction_Publish);
+    if (record.m_dataLen < 4U) {
+        return cc_tools_qt::DataInfoPtr();
+    }
+
+    auto propsLen = static_cast<std::size_t>(readU32(record.m_data));
+    if ((record.m_dataLen - 4U) < propsLen) {
+        return cc_tools_qt::DataInfoPtr();
+    }
+
+    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
+    {
+        auto props = QByteArray::fromRawData(reinterpret_cast<const char*>(record.m_data + 4), static_cast<int>(propsLen));
+        QDataStream stream(props);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream >> dataInfo->m_extraProperties;
+    }
+
+    dataInfo->m_data.assign(record.m_data + 4U + propsLen, record.m_data + record.m_dataLen);
+    return dataInfo;
+}
+
+bool MqttsnClientFilterCapture::growInternal(std::size_t required)
+{
+    assert(m_writable);
+    if (m_map != nullptr) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    auto capacity = m_capacity + std::max(GrowStep, static_cast<qint64>(required));
+    if (!m_file.resize(capacity)) {
+        return false;
+    }
+
+    m_map = m_file.map(0, capacity);
+    if (m_map == nullptr) {
+        return false;
+    }
+
+    m_capacity = capacity;
+    return true;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,98 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cc_tools_qt/DataInfo.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Capture file of the raw MQTT-SN frames exchanged with the gateway and
+// the application messages given to the filter for publishing. The records
+// are appended to the memory mapped file, which is extended in fixed steps
+// and truncated to the actual size on close. The same file is memory mapped
+// read-only for the replay.
+class MqttsnClientFilterCapture
+{
+public:
+    // Zero value marks the unused tail of the unexpectedly terminated capture
+    enum Direction : std::uint8_t
+    {
+        Direction_In = 1, // frame received from the gateway
+        Direction_Out = 2, // frame sent to the gateway
+        Direction_Publish = 3, // application message to publish
+    };
+
+    struct Record
+    {
+        qint64 m_timestampUs = 0; // monotonic, since the capture start
+        Direction m_direction = Direction_In;
+        const std::uint8_t* m_data = nullptr;
+        std::size_t m_dataLen = 0U;
+    };
+
+    MqttsnClientFilterCapture();
+    ~MqttsnClientFilterCapture() noexcept;
+
+    bool open(const QString& path);
+    bool load(const QString& path);
+    void close();
+
+    bool isOpen() const
+    {
+        return m_map != nullptr;
+    }
+
+    QString path() const
+    {
+        return m_file.fileName();
+    }
+
+    bool append(Direction direction, const std::uint8_t* data, std::size_t dataLen);
+    bool appendPublish(const cc_tools_qt::DataInfo& info);
+
+    bool readNext(Record& record);
+    void rewind();
+
+    static cc_tools_qt::DataInfoPtr decodePublish(const Record& record);
+
+private:
+    bool growInternal(std::size_t required);
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_capacity = 0;
+    qint64 m_readPos = 0;
+    bool m_writable = false;
+    std::chrono::steady_clock::time_point m_startTs;
+    QByteArray m_publishBuf;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
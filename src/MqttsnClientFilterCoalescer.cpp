@@ -0,0 +1,186 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterCoalescer.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::uint8_t Marker[] = {0xcc, 0x01};
+const std::size_t MarkerLen = std::extent<decltype(Marker)>::value;
+const std::size_t RecordHeaderLen = 2U;
+const std::size_t MaxRecordLen = std::numeric_limits<std::uint16_t>::max();
+
+} // namespace
+
+void MqttsnClientFilterCoalescer::setLimits(unsigned windowMs, unsigned maxSize)
+{
+    m_windowUs = static_cast<qint64>(windowMs) * 1000;
+    m_maxSize = maxSize;
+}
+
+void MqttsnClientFilterCoalescer::setMergedProps(const QString& expiryProp, const QString& priorityProp)
+{
+    m_expiryProp = expiryProp;
+    m_priorityProp = priorityProp;
+}
+
+void MqttsnClientFilterCoalescer::add(const std::string& key, cc_tools_qt::DataInfoPtr dataPtr, qint64 nowUs, DataInfosList& ready)
+{
+    if (MaxRecordLen < dataPtr->m_data.size()) {
+        // Cannot be coalesced, published as is
+        ready.push_back(std::move(dataPtr));
+        return;
+    }
+
+    auto iter = m_batches.find(key);
+    auto recLen = RecordHeaderLen + dataPtr->m_data.size();
+    if ((iter != m_batches.end()) && (m_maxSize < (iter->second.m_envelope->m_data.size() + recLen))) {
+        ready.push_back(std::move(iter->second.m_envelope));
+        m_batches.erase(iter);
+        iter = m_batches.end();
+    }
+
+    if (iter == m_batches.end()) {
+        Batch batch;
+        batch.m_envelope = makeEnvelope(*dataPtr);
+        batch.m_deadlineUs = nowUs + m_windowUs;
+        iter = m_batches.emplace(key, std::move(batch)).first;
+    }
+    else {
+        mergeProps(*iter->second.m_envelope, *dataPtr);
+    }
+
+    appendRecord(*iter->second.m_envelope, *dataPtr);
+    if ((m_windowUs == 0) || (m_maxSize <= iter->second.m_envelope->m_data.size())) {
+        ready.push_back(std::move(iter->second.m_envelope));
+        m_batches.erase(iter);
+    }
+}
+
+void MqttsnClientFilterCoalescer::takeExpired(qint64 nowUs, DataInfosList& ready)
+{
+    for (auto iter = m_batches.begin(); iter != m_batches.end(); ) {
+        if (nowUs < iter->second.m_deadlineUs) {
+            ++iter;
+            continue;
+        }
+
+        ready.push_back(std::move(iter->second.m_envelope));
+        iter = m_batches.erase(iter);
+    }
+}
+
+void MqttsnClientFilterCoalescer::takeAll(DataInfosList& ready)
+{
+    for (auto& b : m_batches) {
+        ready.push_back(std::move(b.second.m_envelope));
+    }
+
+    m_batches.clear();
+}
+
+qint64 MqttsnClientFilterCoalescer::nextDeadlineUs() const
+{
+    qint64 result = 0;
+    for (auto& b : m_batches) {
+        if ((result == 0) || (b.second.m_deadlineUs < result)) {
+            result = b.second.m_deadlineUs;
+        }
+    }
+
+    return result;
+}
+
+bool MqttsnClientFilterCoalescer::unpack(const std::uint8_t* data, std::size_t len, RecordsList& records)
+{
+    records.clear();
+    if ((len < MarkerLen) || (!std::equal(std::begin(Marker), std::end(Marker), data))) {
+        return false;
+    }
+
+    auto* pos = data + MarkerLen;
+    auto* end = data + len;
+    while (pos < end) {
+        if (static_cast<std::size_t>(end - pos) < RecordHeaderLen) {
+            return false;
+        }
+
+        auto recLen = 
+            (static_cast<std::size_t>(pos[0]) << 8U) | 
+            static_cast<std::size_t>(pos[1]);
+
+        pos += RecordHeaderLen;
+        if (static_cast<std::size_t>(end - pos) < recLen) {
+            return false;
+        }
+
+        records.emplace_back(pos, recLen);
+        pos += recLen;
+    }
+
+    return true;
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilterCoalescer::makeEnvelope(const cc_tools_qt::DataInfo& first) const
+{
+    auto envelope = cc_tools_qt::makeDataInfoTimed();
+    envelope->m_extraProperties = first.m_extraProperties;
+    envelope->m_data.reserve(std::max(m_maxSize, MarkerLen + RecordHeaderLen + first.m_data.size()));
+    envelope->m_data.assign(std::begin(Marker), std::end(Marker));
+    return envelope;
+}
+
+void MqttsnClientFilterCoalescer::mergeProps(cc_tools_qt::DataInfo& envelope, const cc_tools_qt::DataInfo& info) const
+{
+    auto& props = envelope.m_extraProperties;
+    if (!m_expiryProp.isEmpty()) {
+        auto var = info.m_extraProperties.value(m_expiryProp);
+        auto currVar = props.value(m_expiryProp);
+        if ((var.isValid()) && (var.canConvert<qint64>()) && 
+            ((!currVar.isValid()) || (!currVar.canConvert<qint64>()) || (var.value<qint64>() < currVar.value<qint64>()))) {
+            props[m_expiryProp] = var;
+        }
+    }
+
+    if (!m_priorityProp.isEmpty()) {
+        auto var = info.m_extraProperties.value(m_priorityProp);
+        auto currVar = props.value(m_priorityProp);
+        if ((var.isValid()) && (var.canConvert<int>()) && 
+            ((!currVar.isValid()) || (!currVar.canConvert<int>()) || (var.value<int>() < currVar.value<int>()))) {
+            props[m_priorityProp] = var;
+        }
+    }
+}
+
+void MqttsnClientFilterCoalescer::appendRecord(cc_tools_qt::DataInfo& envelope, const cc_tools_qt::DataInfo& info)
+{
+    auto len = info.m_data.size();
+    envelope.m_data.push_back(static_cast<std::uint8_t>((len >> 8U) & 0xff));
+    envelope.m_data.push_back(static_cast<std::uint8_t>(len & 0xff));
+    envelope.m_data.insert(envelope.m_data.end(), info.m_data.begin(), info.m_data.end());
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,84 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cc_tools_qt/DataInfo.h>
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Packs small payloads published to the same topic into a single envelope:
+// the 2 bytes marker followed by the [u16 length][payload] records.
+// The envelope carries the properties of its first message, except
+// the expiry, which is the earliest one, and the priority, which is 
+// the most urgent (lowest lane index) one of all the records.
+class MqttsnClientFilterCoalescer
+{
+public:
+    using DataInfosList = std::vector<cc_tools_qt::DataInfoPtr>;
+    using Record = std::pair<const std::uint8_t*, std::size_t>;
+    using RecordsList = std::vector<Record>;
+
+    void setLimits(unsigned windowMs, unsigned maxSize);
+    void setMergedProps(const QString& expiryProp, const QString& priorityProp);
+    void add(const std::string& key, cc_tools_qt::DataInfoPtr dataPtr, qint64 nowUs, DataInfosList& ready);
+    void takeExpired(qint64 nowUs, DataInfosList& ready);
+    void takeAll(DataInfosList& ready);
+    qint64 nextDeadlineUs() const;
+
+    bool isEmpty() const
+    {
+        return m_batches.empty();
+    }
+
+    static bool unpack(const std::uint8_t* data, std::size_t len, RecordsList& records);
+
+private:
+    struct Batch
+    {
+        cc_tools_qt::DataInfoPtr m_envelope;
+        qint64 m_deadlineUs = 0;
+    };
+
+    using BatchesMap = std::map<std::string, Batch>;
+
+    cc_tools_qt::DataInfoPtr makeEnvelope(const cc_tools_qt::DataInfo& first) const;
+    void mergeProps(cc_tools_qt::DataInfo& envelope, const cc_tools_qt::DataInfo& info) const;
+    static void appendRecord(cc_tools_qt::DataInfo& envelope, const cc_tools_qt::DataInfo& info);
+
+    BatchesMap m_batches;
+    qint64 m_windowUs = 0;
+    std::size_t m_maxSize = 0U;
+    QString m_expiryProp;
+    QString m_priorityProp;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,323 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterConfigIo.h"
+
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+
+const QString MainConfigKey("cc_plugin_mqttsn_client_filter");
+const QString RetryPeriodSubKey("retry_period");
+const QString RetryCountSubKey("retry_count");
+const QString AdaptiveRetrySubKey("adaptive_retry");
+const QString MinRetryPeriodSubKey("min_retry_period");
+const QString MaxRetryPeriodSubKey("max_retry_period");
+const QString ClientIdSubKey("client_id");
+const QString KeepAliveKey("keep_alive");
+const QString TopicAliasMaxKey("topic_alias_max");
+const QString ForceCleanSessionSubKey("force_clean_session");
+const QString SessionFileSubKey("session_file");
+const QString SpillDirSubKey("spill_dir");
+const QString CaptureFileSubKey("capture_file");
+const QString StreamFramingSubKey("stream_framing");
+const QString SpillThresholdSubKey("spill_threshold");
+const QString PubTopicSubKey("pub_topic");
+const QString PubTopicIdSubKey("pub_topic_id");
+const QString PubQosSubKey("pub_qos");
+const QString SubTopicSubKey("sub_topic");
+const QString SubTopicIdSubKey("sub_topic_id");
+const QString SubQosSubKey("sub_qos");
+const QString SubscribesSubKey("subscribes");
+const QString LaneTopicsSubKey("topics");
+const QString LaneWeightSubKey("weight");
+const QString LanesSubKey("lanes");
+const QString PubMaxInFlightSubKey("pub_max_in_flight");
+const QString PubRateSubKey("pub_rate");
+const QString PubBurstSubKey("pub_burst");
+const QString TopicPubRateSubKey("topic_pub_rate");
+const QString CoalesceTopicsSubKey("coalesce_topics");
+const QString CoalesceWindowSubKey("coalesce_window");
+const QString CoalesceMaxSizeSubKey("coalesce_max_size");
+const QString FragmentSizeSubKey("fragment_size");
+const QString FragmentWindowSubKey("fragment_window");
+const QString ReassemblyMaxSizeSubKey("reassembly_max_size");
+const QString ReassemblyTimeoutSubKey("reassembly_timeout");
+const QString ReassemblyMaxTotalSubKey("reassembly_max_total");
+const QString ReassemblyTopicsSubKey("reassembly_topics");
+const QString CompressTopicsSubKey("compress_topics");
+const QString CompressLevelSubKey("compress_level");
+const QString CompressMinSizeSubKey("compress_min_size");
+const QString DedupTopicsSubKey("dedup_topics");
+const QString DedupHeartbeatSubKey("dedup_heartbeat");
+const QString DedupDeadbandSubKey("dedup_deadband");
+const QString RxDedupWindowSubKey("rx_dedup_window");
+const QString RxDedupTopicsSubKey("rx_dedup_topics");
+const QString RxExcludeTopicsSubKey("rx_exclude_topics");
+const QString LastValueCacheSizeSubKey("last_value_cache_size");
+const QString LastValueMaxEntrySizeSubKey("last_value_max_entry_size");
+const QString TopicStatsLimitSubKey("topic_stats_limit");
+const QString ProbeTopicSubKey("probe_topic");
+const QString ProbeIntervalSubKey("probe_interval");
+const QString ProbeQosSubKey("probe_qos");
+const QString RxLimitTopicsSubKey("topics");
+const QString RxLimitModeSubKey("mode");
+const QString RxLimitRateSubKey("rate");
+const QString RxLimitIntervalSubKey("interval");
+const QString RxLimitsSubKey("rx_limits");
+const QString PubRuleTopicsSubKey("topics");
+const QString PubRuleQosSubKey("qos");
+const QString PubRuleRetainSubKey("retain");
+const QString PubRulePrioritySubKey("priority");
+const QString PubRuleTtlSubKey("ttl");
+const QString PubRulesSubKey("pub_rules");
+
+
+template <typename T>
+void getFromConfigMap(const QVariantMap& subConfig, const QString& key, T& val)
+{
+    using Type = std::decay_t<decltype(val)>;
+    auto var = subConfig.value(key);
+    if (var.isValid() && var.canConvert<Type>()) {
+        val = var.value<Type>();
+    }    
+}
+
+QVariantMap toVariantMap(const MqttsnClientFilter::SubConfig& config)
+{
+    QVariantMap result;
+    result[SubTopicSubKey] = config.m_topic;
+    result[SubTopicIdSubKey] = config.m_topicId;
+    result[SubQosSubKey] = config.m_maxQos;
+    return result;
+}
+
+void fromVariantMap(const QVariantMap& map, MqttsnClientFilter::SubConfig& config)
+{
+    getFromConfigMap(map, SubTopicSubKey, config.m_topic);
+    getFromConfigMap(map, SubTopicIdSubKey, config.m_topicId);
+    getFromConfigMap(map, SubQosSubKey, config.m_maxQos);
+}
+
+QVariantMap toVariantMap(const MqttsnClientFilter::LaneConfig& config)
+{
+    QVariantMap result;
+    result[LaneTopicsSubKey] = config.m_topics;
+    result[LaneWeightSubKey] = config.m_weight;
+    return result;
+}
+
+void fromVariantMap(const QVariantMap& map, MqttsnClientFilter::LaneConfig& config)
+{
+    getFromConfigMap(map, LaneTopicsSubKey, config.m_topics);
+    getFromConfigMap(map, LaneWeightSubKey, config.m_weight);
+}
+
+QVariantMap toVariantMap(const MqttsnClientFilter::RxLimitConfig& config)
+{
+    QVariantMap result;
+    result[RxLimitTopicsSubKey] = config.m_topics;
+    result[RxLimitModeSubKey] = config.m_mode;
+    result[RxLimitRateSubKey] = config.m_rate;
+    result[RxLimitIntervalSubKey] = config.m_interval;
+    return result;
+}
+
+void fromVariantMap(const QVariantMap& map, MqttsnClientFilter::RxLimitConfig& config)
+{
+    getFromConfigMap(map, RxLimitTopicsSubKey, config.m_topics);
+    getFromConfigMap(map, RxLimitModeSubKey, config.m_mode);
+    getFromConfigMap(map, RxLimitRateSubKey, config.m_rate);
+    getFromConfigMap(map, RxLimitIntervalSubKey, config.m_interval);
+}
+
+QVariantMap toVariantMap(const MqttsnClientFilter::PubRuleConfig& config)
+{
+    QVariantMap result;
+    result[PubRuleTopicsSubKey] = config.m_topics;
+    result[PubRuleQosSubKey] = config.m_qos;
+    result[PubRuleRetainSubKey] = config.m_retain;
+    result[PubRulePrioritySubKey] = config.m_priority;
+    result[PubRuleTtlSubKey] = config.m_ttl;
+    return result;
+}
+
+void fromVariantMap(const QVariantMap& map, MqttsnClientFilter::PubRuleConfig& config)
+{
+    getFromConfigMap(map, PubRuleTopicsSubKey, config.m_topics);
+    getFromConfigMap(map, PubRuleQosSubKey, config.m_qos);
+    getFromConfigMap(map, PubRuleRetainSubKey, config.m_retain);
+    getFromConfigMap(map, PubRulePrioritySubKey, config.m_priority);
+    getFromConfigMap(map, PubRuleTtlSubKey, config.m_ttl);
+}
+
+template <typename T>
+QVariantList toVariantList(const T& configsList)
+{
+    QVariantList result;
+    for (auto& info : configsList) {
+        result.append(toVariantMap(info));
+    }
+    return result;
+}
+
+template <typename T>
+void getListFromConfigMap(const QVariantMap& subConfig, const QString& key, T& list)
+{
+    list.clear();
+
+    auto var = subConfig.value(key);
+    if ((!var.isValid()) || (!var.canConvert<QVariantList>())) {
+        return;
+    }    
+
+    auto varList = var.value<QVariantList>();
+    for (auto& elemVar : varList) {
+
+        if ((!elemVar.isValid()) || (!elemVar.canConvert<QVariantMap>())) {
+            return;
+        }            
+
+        auto varMap = elemVar.value<QVariantMap>();
+
+        list.resize(list.size() + 1U);
+        fromVariantMap(varMap, list.back());
+    }
+}
+
+} // namespace
+
+void MqttsnClientFilterConfigIo::saveConfig(const Config& cfg, QVariantMap& config)
+{
+    QVariantMap subConfig;
+    subConfig.insert(RetryPeriodSubKey, cfg.m_retryPeriod);
+    subConfig.insert(RetryCountSubKey, cfg.m_retryCount);
+    subConfig.insert(AdaptiveRetrySubKey, cfg.m_adaptiveRetry);
+    subConfig.insert(MinRetryPeriodSubKey, cfg.m_minRetryPeriod);
+    subConfig.insert(MaxRetryPeriodSubKey, cfg.m_maxRetryPeriod);
+    subConfig.insert(ClientIdSubKey, cfg.m_clientId);
+    subConfig.insert(KeepAliveKey, cfg.m_keepAlive);
+    subConfig.insert(ForceCleanSessionSubKey, cfg.m_forcedCleanSession);
+    subConfig.insert(SessionFileSubKey, cfg.m_sessionFile);
+    subConfig.insert(SpillDirSubKey, cfg.m_spillDir);
+    subConfig.insert(CaptureFileSubKey, cfg.m_captureFile);
+    subConfig.insert(StreamFramingSubKey, cfg.m_streamFraming);
+    subConfig.insert(SpillThresholdSubKey, cfg.m_spillThreshold);
+    subConfig.insert(PubTopicSubKey, cfg.m_pubTopic);
+    subConfig.insert(PubTopicIdSubKey, cfg.m_pubTopicId);
+    subConfig.insert(PubQosSubKey, cfg.m_pubQos);
+    subConfig.insert(SubscribesSubKey, toVariantList(cfg.m_subscribes));
+    subConfig.insert(LanesSubKey, toVariantList(cfg.m_lanes));
+    subConfig.insert(PubMaxInFlightSubKey, cfg.m_pubMaxInFlight);
+    subConfig.insert(PubRateSubKey, cfg.m_pubRate);
+    subConfig.insert(PubBurstSubKey, cfg.m_pubBurst);
+    subConfig.insert(TopicPubRateSubKey, cfg.m_topicPubRate);
+    subConfig.insert(CoalesceTopicsSubKey, cfg.m_coalesceTopics);
+    subConfig.insert(CoalesceWindowSubKey, cfg.m_coalesceWindow);
+    subConfig.insert(CoalesceMaxSizeSubKey, cfg.m_coalesceMaxSize);
+    subConfig.insert(FragmentSizeSubKey, cfg.m_fragmentSize);
+    subConfig.insert(FragmentWindowSubKey, cfg.m_fragmentWindow);
+    subConfig.insert(ReassemblyMaxSizeSubKey, cfg.m_reassemblyMaxSize);
+    subConfig.insert(ReassemblyTimeoutSubKey, cfg.m_reassemblyTimeout);
+    subConfig.insert(ReassemblyMaxTotalSubKey, cfg.m_reassemblyMaxTotal);
+    subConfig.insert(ReassemblyTopicsSubKey, cfg.m_reassemblyTopics);
+    subConfig.insert(CompressTopicsSubKey, cfg.m_compressTopics);
+    subConfig.insert(CompressLevelSubKey, cfg.m_compressLevel);
+    subConfig.insert(CompressMinSizeSubKey, cfg.m_compressMinSize);
+    subConfig.insert(DedupTopicsSubKey, cfg.m_dedupTopics);
+    subConfig.insert(DedupHeartbeatSubKey, cfg.m_dedupHeartbeat);
+    subConfig.insert(DedupDeadbandSubKey, cfg.m_dedupDeadband);
+    subConfig.insert(RxDedupWindowSubKey, cfg.m_rxDedupWindow);
+    subConfig.insert(RxDedupTopicsSubKey, cfg.m_rxDedupTopics);
+    subConfig.insert(RxExcludeTopicsSubKey, cfg.m_rxExcludeTopics);
+    subConfig.insert(LastValueCacheSizeSubKey, cfg.m_lastValueCacheSize);
+    subConfig.insert(LastValueMaxEntrySizeSubKey, cfg.m_lastValueMaxEntrySize);
+    subConfig.insert(TopicStatsLimitSubKey, cfg.m_topicStatsLimit);
+    subConfig.insert(ProbeTopicSubKey, cfg.m_probeTopic);
+    subConfig.insert(ProbeIntervalSubKey, cfg.m_probeInterval);
+    subConfig.insert(ProbeQosSubKey, cfg.m_probeQos);
+    subConfig.insert(RxLimitsSubKey, toVariantList(cfg.m_rxLimits));
+    subConfig.insert(PubRulesSubKey, toVariantList(cfg.m_pubRules));
+    config.insert(MainConfigKey, QVariant::fromValue(subConfig));
+}
+
+bool MqttsnClientFilterConfigIo::loadConfig(const QVariantMap& config, Config& cfg)
+{
+    auto subConfigVar = config.value(MainConfigKey);
+    if ((!subConfigVar.isValid()) || (!subConfigVar.canConvert<QVariantMap>())) {
+        return false;
+    }
+
+    auto subConfig = subConfigVar.value<QVariantMap>();
+
+    getFromConfigMap(subConfig, RetryPeriodSubKey, cfg.m_retryPeriod);
+    getFromConfigMap(subConfig, RetryCountSubKey, cfg.m_retryCount);
+    getFromConfigMap(subConfig, AdaptiveRetrySubKey, cfg.m_adaptiveRetry);
+    getFromConfigMap(subConfig, MinRetryPeriodSubKey, cfg.m_minRetryPeriod);
+    getFromConfigMap(subConfig, MaxRetryPeriodSubKey, cfg.m_maxRetryPeriod);
+    getFromConfigMap(subConfig, ClientIdSubKey, cfg.m_clientId);
+    getFromConfigMap(subConfig, KeepAliveKey, cfg.m_keepAlive);
+    getFromConfigMap(subConfig, ForceCleanSessionSubKey, cfg.m_forcedCleanSession);
+    getFromConfigMap(subConfig, SessionFileSubKey, cfg.m_sessionFile);
+    getFromConfigMap(subConfig, SpillDirSubKey, cfg.m_spillDir);
+    getFromConfigMap(subConfig, CaptureFileSubKey, cfg.m_captureFile);
+    getFromConfigMap(subConfig, StreamFramingSubKey, cfg.m_streamFraming);
+    getFromConfigMap(subConfig, SpillThresholdSubKey, cfg.m_spillThreshold);
+    getFromConfigMap(subConfig, PubTopicSubKey, cfg.m_pubTopic);
+    getFromConfigMap(subConfig, PubTopicIdSubKey, cfg.m_pubTopicId);
+    getFromConfigMap(subConfig, PubQosSubKey, cfg.m_pubQos);
+    getListFromConfigMap(subConfig, SubscribesSubKey, cfg.m_subscribes);
+    getListFromConfigMap(subConfig, LanesSubKey, cfg.m_lanes);
+    getFromConfigMap(subConfig, PubMaxInFlightSubKey, cfg.m_pubMaxInFlight);
+    getFromConfigMap(subConfig, PubRateSubKey, cfg.m_pubRate);
+    getFromConfigMap(subConfig, PubBurstSubKey, cfg.m_pubBurst);
+    getFromConfigMap(subConfig, TopicPubRateSubKey, cfg.m_topicPubRate);
+    getFromConfigMap(subConfig, CoalesceTopicsSubKey, cfg.m_coalesceTopics);
+    getFromConfigMap(subConfig, CoalesceWindowSubKey, cfg.m_coalesceWindow);
+    getFromConfigMap(subConfig, CoalesceMaxSizeSubKey, cfg.m_coalesceMaxSize);
+    getFromConfigMap(subConfig, FragmentSizeSubKey, cfg.m_fragmentSize);
+    getFromConfigMap(subConfig, FragmentWindowSubKey, cfg.m_fragmentWindow);
+    getFromConfigMap(subConfig, ReassemblyMaxSizeSubKey, cfg.m_reassemblyMaxSize);
+    getFromConfigMap(subConfig, ReassemblyTimeoutSubKey, cfg.m_reassemblyTimeout);
+    getFromConfigMap(subConfig, ReassemblyMaxTotalSubKey, cfg.m_reassemblyMaxTotal);
+    getFromConfigMap(subConfig, ReassemblyTopicsSubKey, cfg.m_reassemblyTopics);
+    getFromConfigMap(subConfig, CompressTopicsSubKey, cfg.m_compressTopics);
+    getFromConfigMap(subConfig, CompressLevelSubKey, cfg.m_compressLevel);
+    getFromConfigMap(subConfig, CompressMinSizeSubKey, cfg.m_compressMinSize);
+    getFromConfigMap(subConfig, DedupTopicsSubKey, cfg.m_dedupTopics);
+    getFromConfigMap(subConfig, DedupHeartbeatSubKey, cfg.m_dedupHeartbeat);
+    getFromConfigMap(subConfig, DedupDeadbandSubKey, cfg.m_dedupDeadband);
+    getFromConfigMap(subConfig, RxDedupWindowSubKey, cfg.m_rxDedupWindow);
+    getFromConfigMap(subConfig, RxDedupTopicsSubKey, cfg.m_rxDedupTopics);
+    getFromConfigMap(subConfig, RxExcludeTopicsSubKey, cfg.m_rxExcludeTopics);
+    getFromConfigMap(subConfig, LastValueCacheSizeSubKey, cfg.m_lastValueCacheSize);
+    getFromConfigMap(subConfig, LastValueMaxEntrySizeSubKey, cfg.m_lastValueMaxEntrySize);
+    getFromConfigMap(subConfig, TopicStatsLimitSubKey, cfg.m_topicStatsLimit);
+    getFromConfigMap(subConfig, ProbeTopicSubKey, cfg.m_probeTopic);
+    getFromConfigMap(subConfig, ProbeIntervalSubKey, cfg.m_probeInterval);
+    getFromConfigMap(subConfig, ProbeQosSubKey, cfg.m_probeQos);
+    getListFromConfigMap(subConfig, RxLimitsSubKey, cfg.m_rxLimits);
+    getListFromConfigMap(subConfig, PubRulesSubKey, cfg.m_pubRules);
+    return true;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,43 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+
+#include <QtCore/QVariantMap>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Conversion of the filter configuration to and from the map stored
+// by the cc_tools_qt configuration files.
+class MqttsnClientFilterConfigIo
+{
+public:
+    using Config = MqttsnClientFilter::Config;
+
+    static void saveConfig(const Config& cfg, QVariantMap& config);
+
+    // Returns false when the map doesn't contain the filter configuration
+    static bool loadConfig(const QVariantMap& config, Config& cfg);
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
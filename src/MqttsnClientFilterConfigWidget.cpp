@@ -17,33 +17,55 @@
 
 #include "MqttsnClientFilterConfigWidget.h"
 
-#include "MqttsnClientFilterSubConfigWidget.h"
+#include "MqttsnClientFilterSubsDelegate.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <vector>
 
 #include <QtCore/QtGlobal>
+#include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QStringList>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QHeaderView>
 
 namespace cc_plugin_mqttsn_client_filter
 {
 
-namespace 
+namespace
 {
 
-void deleteAllWidgetsFrom(QLayout& layout)
+const QString SubsFilesFilter("CSV (*.csv);;JSON (*.json)");
+const QString CsvFilesFilter("CSV (*.csv)");
+const int PerfRefreshPeriod = 250; // ms
+
+QString connectionStatusStr(const MqttsnClientFilter::PerfSnapshot& snapshot)
 {
-    while (true) {
-        auto* child = layout.takeAt(0);
-        if (child == nullptr) {
-            break;
-        }
+    if (!snapshot.m_socketConnected) {
+        return QObject::tr("No Socket");
+    }
+
+    switch (snapshot.m_connectionStatus) {
+        case CC_MqttsnConnectionStatus_Disconnected: return QObject::tr("Disconnected");
+        case CC_MqttsnConnectionStatus_Connected: return QObject::tr("Connected");
+        case CC_MqttsnConnectionStatus_Asleep: return QObject::tr("Asleep");
+        default: break;
+    }
+
+    return QString("???");
+}
 
-        delete child->widget();
-        delete child;
+double perfRate(unsigned long long curr, unsigned long long prev, qint64 elapsedUs)
+{
+    if ((elapsedUs <= 0) || (curr < prev)) {
+        return 0.0;
     }
+
+    return static_cast<double>(curr - prev) * 1000000.0 / static_cast<double>(elapsedUs);
 }
 
-} // namespace 
-    
+} // namespace
 
 MqttsnClientFilterConfigWidget::MqttsnClientFilterConfigWidget(MqttsnClientFilter& filter, QWidget* parentObj) :
     Base(parentObj),
@@ -51,10 +73,32 @@ MqttsnClientFilterConfigWidget::MqttsnClientFilterConfigWidget(MqttsnClientFilte
 {
     m_ui.setupUi(this);
 
-    auto subsLayout = new QVBoxLayout;
-    m_ui.m_subsWidget->setLayout(subsLayout);
+    // The rows are created on demand by the view, fixed row height avoids
+    // measuring every row when there are thousands of subscriptions.
+    m_subsModel = new MqttsnClientFilterSubsModel(m_filter, this);
+    m_ui.m_subsTableView->setModel(m_subsModel);
+    m_ui.m_subsTableView->setItemDelegate(new MqttsnClientFilterSubsDelegate(this));
+    m_ui.m_subsTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_ui.m_subsTableView->horizontalHeader()->setSectionResizeMode(MqttsnClientFilterSubsModel::Column_Topic, QHeaderView::Stretch);
+    m_ui.m_subsTableView->horizontalHeader()->setStretchLastSection(false);
+
+    // The panel polls the filter snapshot instead of reacting to every message
+    m_rttSparkline = new MqttsnClientFilterSparkline(this);
+    m_ui.m_perfGridLayout->addWidget(m_rttSparkline, 4, 0, 1, 4);
+    m_prevPerf = m_filter.perfSnapshot();
+    m_perfTimer.setInterval(PerfRefreshPeriod);
+
+    m_topicStatsModel = new MqttsnClientFilterTopicStatsModel(m_filter, this);
+    auto* topicStatsProxy = new QSortFilterProxyModel(this);
+    topicStatsProxy->setSourceModel(m_topicStatsModel);
+    topicStatsProxy->setSortRole(MqttsnClientFilterTopicStatsModel::SortRole);
+    m_ui.m_topicStatsTableView->setModel(topicStatsProxy);
+    m_ui.m_topicStatsTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_ui.m_topicStatsTableView->horizontalHeader()->setSectionResizeMode(MqttsnClientFilterTopicStatsModel::Column_Topic, QHeaderView::Stretch);
+    m_ui.m_topicStatsTableView->horizontalHeader()->setSortIndicator(MqttsnClientFilterTopicStatsModel::Column_TxBytes, Qt::DescendingOrder);
 
     refresh();
+    refreshPerf();
 
     connect(
         &m_filter, &MqttsnClientFilter::sigConfigChanged,
@@ -68,6 +112,18 @@ MqttsnClientFilterConfigWidget::MqttsnClientFilterConfigWidget(MqttsnClientFilte
         m_ui.m_retryCountSpinBox, qOverload<int>(&QSpinBox::valueChanged),
         this, &MqttsnClientFilterConfigWidget::retryCountUpdated);             
 
+    connect(
+        m_ui.m_adaptiveRetryComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+        this, &MqttsnClientFilterConfigWidget::adaptiveRetryUpdated);
+
+    connect(
+        m_ui.m_minRetryPeriodSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::minRetryPeriodUpdated);
+
+    connect(
+        m_ui.m_maxRetryPeriodSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::maxRetryPeriodUpdated);
+
     connect(
         m_ui.m_clientIdLineEdit, &QLineEdit::textChanged,
         this, &MqttsnClientFilterConfigWidget::clientIdUpdated);
@@ -80,6 +136,26 @@ MqttsnClientFilterConfigWidget::MqttsnClientFilterConfigWidget(MqttsnClientFilte
         m_ui.m_cleanSessionComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
         this, &MqttsnClientFilterConfigWidget::forcedCleanSessionUpdated);           
 
+    connect(
+        m_ui.m_sessionFileLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::sessionFileUpdated);
+
+    connect(
+        m_ui.m_spillDirLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::spillDirUpdated);
+
+    connect(
+        m_ui.m_spillThresholdSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::spillThresholdUpdated);
+
+    connect(
+        m_ui.m_captureFileLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::captureFileUpdated);
+
+    connect(
+        m_ui.m_streamFramingComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+        this, &MqttsnClientFilterConfigWidget::streamFramingUpdated);
+
     connect(
         m_ui.m_pubTopicLineEdit, &QLineEdit::textChanged,
         this, &MqttsnClientFilterConfigWidget::pubTopicUpdated);       
@@ -92,29 +168,203 @@ MqttsnClientFilterConfigWidget::MqttsnClientFilterConfigWidget(MqttsnClientFilte
         m_ui.m_pubQosSpinBox, qOverload<int>(&QSpinBox::valueChanged),
         this, &MqttsnClientFilterConfigWidget::pubQosUpdated);   
 
+    connect(
+        m_ui.m_pubMaxInFlightSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::pubMaxInFlightUpdated);   
+
+    connect(
+        m_ui.m_pubRateSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::pubRateUpdated);
+
+    connect(
+        m_ui.m_pubBurstSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::pubBurstUpdated);
+
+    connect(
+        m_ui.m_topicPubRateSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::topicPubRateUpdated);
+
+    connect(
+        m_ui.m_coalesceTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::coalesceTopicsUpdated);
+
+    connect(
+        m_ui.m_coalesceWindowSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::coalesceWindowUpdated);
+
+    connect(
+        m_ui.m_coalesceMaxSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::coalesceMaxSizeUpdated);
+
+    connect(
+        m_ui.m_fragmentSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::fragmentSizeUpdated);
+
+    connect(
+        m_ui.m_fragmentWindowSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::fragmentWindowUpdated);
+
+    connect(
+        m_ui.m_reassemblyMaxSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::reassemblyMaxSizeUpdated);
+
+    connect(
+        m_ui.m_reassemblyTimeoutSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::reassemblyTimeoutUpdated);
+
+    connect(
+        m_ui.m_reassemblyMaxTotalSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::reassemblyMaxTotalUpdated);
+
+    connect(
+        m_ui.m_reassemblyTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::reassemblyTopicsUpdated);
+
+    connect(
+        m_ui.m_compressTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::compressTopicsUpdated);
+
+    connect(
+        m_ui.m_compressLevelSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::compressLevelUpdated);
+
+    connect(
+        m_ui.m_compressMinSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::compressMinSizeUpdated);
+
+    connect(
+        m_ui.m_dedupTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::dedupTopicsUpdated);
+
+    connect(
+        m_ui.m_dedupHeartbeatSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::dedupHeartbeatUpdated);
+
+    connect(
+        m_ui.m_dedupDeadbandSpinBox, qOverload<double>(&QDoubleSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::dedupDeadbandUpdated);
+
+    connect(
+        m_ui.m_rxDedupWindowSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::rxDedupWindowUpdated);
+
+    connect(
+        m_ui.m_rxDedupTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::rxDedupTopicsUpdated);
+
+    connect(
+        m_ui.m_rxExcludeTopicsLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::rxExcludeTopicsUpdated);
+
+    connect(
+        m_ui.m_lastValueCacheSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::lastValueCacheSizeUpdated);
+
+    connect(
+        m_ui.m_lastValueMaxEntrySizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::lastValueMaxEntrySizeUpdated);
+
+    connect(
+        m_ui.m_topicStatsLimitSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::topicStatsLimitUpdated);
+
+    connect(
+        m_ui.m_probeTopicLineEdit, &QLineEdit::textChanged,
+        this, &MqttsnClientFilterConfigWidget::probeTopicUpdated);
+
+    connect(
+        m_ui.m_probeIntervalSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::probeIntervalUpdated);
+
+    connect(
+        m_ui.m_probeQosSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &MqttsnClientFilterConfigWidget::probeQosUpdated);
+
     connect(
         m_ui.m_addSubPushButton, &QPushButton::clicked,
         this, &MqttsnClientFilterConfigWidget::addSubscribe);           
+
+    connect(
+        m_ui.m_delSubPushButton, &QPushButton::clicked,
+        this, &MqttsnClientFilterConfigWidget::delSubscribes);
+
+    connect(
+        m_ui.m_importSubsPushButton, &QPushButton::clicked,
+        this, &MqttsnClientFilterConfigWidget::importSubscribes);
+
+    connect(
+        m_ui.m_exportSubsPushButton, &QPushButton::clicked,
+        this, &MqttsnClientFilterConfigWidget::exportSubscribes);
+
+    connect(
+        m_ui.m_clearTopicStatsPushButton, &QPushButton::clicked,
+        this, &MqttsnClientFilterConfigWidget::clearTopicStats);
+
+    connect(
+        m_ui.m_exportTopicStatsPushButton, &QPushButton::clicked,
+        this, &MqttsnClientFilterConfigWidget::exportTopicStats);
+
+    connect(
+        m_ui.m_subsTableView->selectionModel(), &QItemSelectionModel::selectionChanged,
+        this, &MqttsnClientFilterConfigWidget::refreshSubscribes);
+
+    connect(
+        &m_perfTimer, &QTimer::timeout,
+        this, &MqttsnClientFilterConfigWidget::refreshPerf);
+
+    m_perfTimer.start();
 }
 
 MqttsnClientFilterConfigWidget::~MqttsnClientFilterConfigWidget() noexcept = default;
 
 void MqttsnClientFilterConfigWidget::refresh()
 {
-    deleteAllWidgetsFrom(*(m_ui.m_subsWidget->layout()));
-
-    for (auto& subConfig : m_filter.config().m_subscribes) {
-        addSubscribeWidget(subConfig);
-    }    
+    m_subsModel->sync();
 
     m_ui.m_retryPeriodSpinBox->setValue(m_filter.config().m_retryPeriod);
     m_ui.m_retryCountSpinBox->setValue(m_filter.config().m_retryCount);
+    m_ui.m_adaptiveRetryComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_adaptiveRetry));
+    m_ui.m_minRetryPeriodSpinBox->setValue(static_cast<int>(m_filter.config().m_minRetryPeriod));
+    m_ui.m_maxRetryPeriodSpinBox->setValue(static_cast<int>(m_filter.config().m_maxRetryPeriod));
     m_ui.m_clientIdLineEdit->setText(m_filter.config().m_clientId);
     m_ui.m_keepAliveSpinBox->setValue(static_cast<int>(m_filter.config().m_keepAlive));
     m_ui.m_cleanSessionComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_forcedCleanSession));
+    m_ui.m_sessionFileLineEdit->setText(m_filter.config().m_sessionFile);
+    m_ui.m_spillDirLineEdit->setText(m_filter.config().m_spillDir);
+    m_ui.m_spillThresholdSpinBox->setValue(static_cast<int>(m_filter.config().m_spillThreshold));
+    m_ui.m_captureFileLineEdit->setText(m_filter.config().m_captureFile);
+    m_ui.m_streamFramingComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_streamFraming));
     m_ui.m_pubTopicLineEdit->setText(m_filter.config().m_pubTopic);
     m_ui.m_pubTopicIdSpinBox->setValue(m_filter.config().m_pubTopicId);
     m_ui.m_pubQosSpinBox->setValue(m_filter.config().m_pubQos);
+    m_ui.m_pubMaxInFlightSpinBox->setValue(static_cast<int>(m_filter.config().m_pubMaxInFlight));
+    m_ui.m_pubRateSpinBox->setValue(static_cast<int>(m_filter.config().m_pubRate));
+    m_ui.m_pubBurstSpinBox->setValue(static_cast<int>(m_filter.config().m_pubBurst));
+    m_ui.m_topicPubRateSpinBox->setValue(static_cast<int>(m_filter.config().m_topicPubRate));
+    m_ui.m_coalesceTopicsLineEdit->setText(m_filter.config().m_coalesceTopics);
+    m_ui.m_coalesceWindowSpinBox->setValue(static_cast<int>(m_filter.config().m_coalesceWindow));
+    m_ui.m_coalesceMaxSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_coalesceMaxSize));
+    m_ui.m_fragmentSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_fragmentSize));
+    m_ui.m_fragmentWindowSpinBox->setValue(static_cast<int>(m_filter.config().m_fragmentWindow));
+    m_ui.m_reassemblyMaxSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_reassemblyMaxSize));
+    m_ui.m_reassemblyTimeoutSpinBox->setValue(static_cast<int>(m_filter.config().m_reassemblyTimeout));
+    m_ui.m_reassemblyMaxTotalSpinBox->setValue(static_cast<int>(m_filter.config().m_reassemblyMaxTotal));
+    m_ui.m_reassemblyTopicsLineEdit->setText(m_filter.config().m_reassemblyTopics);
+    m_ui.m_compressTopicsLineEdit->setText(m_filter.config().m_compressTopics);
+    m_ui.m_compressLevelSpinBox->setValue(m_filter.config().m_compressLevel);
+    m_ui.m_compressMinSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_compressMinSize));
+    m_ui.m_dedupTopicsLineEdit->setText(m_filter.config().m_dedupTopics);
+    m_ui.m_dedupHeartbeatSpinBox->setValue(static_cast<int>(m_filter.config().m_dedupHeartbeat));
+    m_ui.m_dedupDeadbandSpinBox->setValue(m_filter.config().m_dedupDeadband);
+    m_ui.m_rxDedupWindowSpinBox->setValue(static_cast<int>(m_filter.config().m_rxDedupWindow));
+    m_ui.m_rxDedupTopicsLineEdit->setText(m_filter.config().m_rxDedupTopics);
+    m_ui.m_rxExcludeTopicsLineEdit->setText(m_filter.config().m_rxExcludeTopics);
+    m_ui.m_lastValueCacheSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_lastValueCacheSize));
+    m_ui.m_lastValueMaxEntrySizeSpinBox->setValue(static_cast<int>(m_filter.config().m_lastValueMaxEntrySize));
+    m_ui.m_topicStatsLimitSpinBox->setValue(static_cast<int>(m_filter.config().m_topicStatsLimit));
+    m_ui.m_probeTopicLineEdit->setText(m_filter.config().m_probeTopic);
+    m_ui.m_probeIntervalSpinBox->setValue(static_cast<int>(m_filter.config().m_probeInterval));
+    m_ui.m_probeQosSpinBox->setValue(m_filter.config().m_probeQos);
 
     refreshSubscribes();
     refreshPubTopic();
@@ -130,6 +380,21 @@ void MqttsnClientFilterConfigWidget::retryCountUpdated(int val)
     m_filter.config().m_retryCount = static_cast<unsigned>(val);
 }
 
+void MqttsnClientFilterConfigWidget::adaptiveRetryUpdated(int val)
+{
+    m_filter.config().m_adaptiveRetry = (val > 0);
+}
+
+void MqttsnClientFilterConfigWidget::minRetryPeriodUpdated(int val)
+{
+    m_filter.config().m_minRetryPeriod = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::maxRetryPeriodUpdated(int val)
+{
+    m_filter.config().m_maxRetryPeriod = static_cast<unsigned>(val);
+}
+
 void MqttsnClientFilterConfigWidget::clientIdUpdated(const QString& val)
 {
     if (m_filter.config().m_clientId == val) {
@@ -150,6 +415,31 @@ void MqttsnClientFilterConfigWidget::forcedCleanSessionUpdated(int val)
     m_filter.config().m_forcedCleanSession = (val > 0);
 }
 
+void MqttsnClientFilterConfigWidget::sessionFileUpdated(const QString& val)
+{
+    m_filter.config().m_sessionFile = val;
+}
+
+void MqttsnClientFilterConfigWidget::spillDirUpdated(const QString& val)
+{
+    m_filter.config().m_spillDir = val;
+}
+
+void MqttsnClientFilterConfigWidget::spillThresholdUpdated(int val)
+{
+    m_filter.config().m_spillThreshold = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::captureFileUpdated(const QString& val)
+{
+    m_filter.config().m_captureFile = val;
+}
+
+void MqttsnClientFilterConfigWidget::streamFramingUpdated(int val)
+{
+    m_filter.config().m_streamFraming = (val > 0);
+}
+
 void MqttsnClientFilterConfigWidget::pubTopicUpdated(const QString& val)
 {
     m_filter.config().m_pubTopic = val;
@@ -167,14 +457,313 @@ void MqttsnClientFilterConfigWidget::pubQosUpdated(int val)
     m_filter.config().m_pubQos = val;
 }
 
+void MqttsnClientFilterConfigWidget::pubMaxInFlightUpdated(int val)
+{
+    m_filter.config().m_pubMaxInFlight = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::pubRateUpdated(int val)
+{
+    m_filter.config().m_pubRate = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::pubBurstUpdated(int val)
+{
+    m_filter.config().m_pubBurst = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::topicPubRateUpdated(int val)
+{
+    m_filter.config().m_topicPubRate = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::coalesceTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_coalesceTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::coalesceWindowUpdated(int val)
+{
+    m_filter.config().m_coalesceWindow = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::coalesceMaxSizeUpdated(int val)
+{
+    m_filter.config().m_coalesceMaxSize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::fragmentSizeUpdated(int val)
+{
+    m_filter.config().m_fragmentSize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::fragmentWindowUpdated(int val)
+{
+    m_filter.config().m_fragmentWindow = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::reassemblyMaxSizeUpdated(int val)
+{
+    m_filter.config().m_reassemblyMaxSize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::reassemblyTimeoutUpdated(int val)
+{
+    m_filter.config().m_reassemblyTimeout = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::reassemblyMaxTotalUpdated(int val)
+{
+    m_filter.config().m_reassemblyMaxTotal = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::reassemblyTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_reassemblyTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::compressTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_compressTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::compressLevelUpdated(int val)
+{
+    m_filter.config().m_compressLevel = val;
+}
+
+void MqttsnClientFilterConfigWidget::compressMinSizeUpdated(int val)
+{
+    m_filter.config().m_compressMinSize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::dedupTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_dedupTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::dedupHeartbeatUpdated(int val)
+{
+    m_filter.config().m_dedupHeartbeat = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::dedupDeadbandUpdated(double val)
+{
+    m_filter.config().m_dedupDeadband = val;
+}
+
+void MqttsnClientFilterConfigWidget::rxDedupWindowUpdated(int val)
+{
+    m_filter.config().m_rxDedupWindow = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::rxDedupTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_rxDedupTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::rxExcludeTopicsUpdated(const QString& val)
+{
+    m_filter.config().m_rxExcludeTopics = val;
+}
+
+void MqttsnClientFilterConfigWidget::lastValueCacheSizeUpdated(int val)
+{
+    m_filter.config().m_lastValueCacheSize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::lastValueMaxEntrySizeUpdated(int val)
+{
+    m_filter.config().m_lastValueMaxEntrySize = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::topicStatsLimitUpdated(int val)
+{
+    m_filter.config().m_topicStatsLimit = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::probeTopicUpdated(const QString& val)
+{
+    m_filter.config().m_probeTopic = val;
+}
+
+void MqttsnClientFilterConfigWidget::probeIntervalUpdated(int val)
+{
+    m_filter.config().m_probeInterval = static_cast<unsigned>(val);
+}
+
+void MqttsnClientFilterConfigWidget::probeQosUpdated(int val)
+{
+    m_filter.config().m_probeQos = val;
+}
+
 void MqttsnClientFilterConfigWidget::addSubscribe()
 {
-    auto& subs = m_filter.config().m_subscribes;
-    subs.resize(subs.size() + 1U);
-    addSubscribeWidget(subs.back());
+    m_subsModel->addSubscribe();
+    refreshSubscribes();
+
+    auto newIdx = m_subsModel->index(m_subsModel->rowCount() - 1, MqttsnClientFilterSubsModel::Column_Topic);
+    m_ui.m_subsTableView->scrollToBottom();
+    m_ui.m_subsTableView->edit(newIdx);
+}
+
+void MqttsnClientFilterConfigWidget::delSubscribes()
+{
+    std::vector<int> rows;
+    auto selected = m_ui.m_subsTableView->selectionModel()->selectedRows();
+    for (auto& idx : selected) {
+        rows.push_back(idx.row());
+    }
+
+    // Removing from the bottom keeps the remaining row numbers valid
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    for (auto iter = rows.begin(); iter != rows.end(); ) {
+        auto last = *iter;
+        auto first = last;
+        ++iter;
+        while ((iter != rows.end()) && (*iter == (first - 1))) {
+            first = *iter;
+            ++iter;
+        }
+
+        m_subsModel->removeRows(first, last - first + 1);
+    }
+
     refreshSubscribes();
 }
 
+void MqttsnClientFilterConfigWidget::importSubscribes()
+{
+    auto path = QFileDialog::getOpenFileName(this, tr("Import Subscribes"), QString(), SubsFilesFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    // The view is updated by the config change notification
+    m_filter.importSubscribes(path);
+}
+
+void MqttsnClientFilterConfigWidget::exportSubscribes()
+{
+    auto path = QFileDialog::getSaveFileName(this, tr("Export Subscribes"), QString(), SubsFilesFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    m_filter.exportSubscribes(path);
+}
+
+void MqttsnClientFilterConfigWidget::refreshPerf()
+{
+    auto snapshot = m_filter.perfSnapshot();
+    auto elapsedUs = snapshot.m_timestampUs - m_prevPerf.m_timestampUs;
+    auto pubRate = perfRate(snapshot.m_published, m_prevPerf.m_published, elapsedUs);
+    auto recvRate = perfRate(snapshot.m_received, m_prevPerf.m_received, elapsedUs);
+
+    m_ui.m_perfConnLabel->setText(connectionStatusStr(snapshot));
+    m_ui.m_perfPubRateLabel->setText(QString::number(pubRate, 'f', 1));
+    m_ui.m_perfRecvRateLabel->setText(QString::number(recvRate, 'f', 1));
+    m_ui.m_perfRttLabel->setText(
+        QString::number(snapshot.m_srttMs, 'f', 1) + " (" + tr("last") + ' ' + QString::number(snapshot.m_lastRttMs, 'f', 1) + ')');
+    m_ui.m_perfPendingLabel->setText(QString::number(snapshot.m_pending));
+    m_ui.m_perfInFlightLabel->setText(QString::number(snapshot.m_inFlight));
+    m_ui.m_perfRetriesLabel->setText(QString::number(snapshot.m_retransmits));
+    m_ui.m_perfTimeoutsLabel->setText(QString::number(snapshot.m_timeouts));
+    m_ui.m_perfPoolLabel->setText(QString::number(snapshot.m_poolHits) + " / " + QString::number(snapshot.m_poolMisses));
+    m_ui.m_perfPubExpiredLabel->setText(QString::number(m_filter.pubExpired()));
+
+    QStringList lanesInfo;
+    auto lanes = m_filter.laneStats();
+    for (auto idx = 0U; idx < lanes.size(); ++idx) {
+        auto& lane = lanes[idx];
+        double avgLatencyMs = 0.0;
+        if (0U < lane.m_dispatched) {
+            avgLatencyMs = static_cast<double>(lane.m_totalLatencyUs) / static_cast<double>(lane.m_dispatched) / 1000.0;
+        }
+
+        lanesInfo.append(
+            QString("%1: %2 / %3 / %4")
+                .arg(idx)
+                .arg(lane.m_depth)
+                .arg(avgLatencyMs, 0, 'f', 1)
+                .arg(static_cast<double>(lane.m_maxLatencyUs) / 1000.0, 0, 'f', 1));
+    }
+    m_ui.m_perfLanesLabel->setText(lanesInfo.join("; "));
+
+    auto& compress = m_filter.compressStats();
+    double compressRatio = 1.0;
+    if (0U < compress.m_bytesIn) {
+        compressRatio = static_cast<double>(compress.m_bytesOut) / static_cast<double>(compress.m_bytesIn);
+    }
+    m_ui.m_perfCompressLabel->setText(
+        QString::number(compressRatio, 'f', 3) + " (" + QString::number(compress.m_compressed) + ' ' + tr("compressed") + ", " +
+        QString::number(compress.m_skipped) + ' ' + tr("skipped") + ')');
+    m_ui.m_perfCompressCpuLabel->setText(QString::number(static_cast<double>(compress.m_cpuUs) / 1000.0, 'f', 1));
+
+    unsigned long long dedupSent = 0U;
+    unsigned long long dedupSuppressed = 0U;
+    QStringList dedupInfo;
+    for (auto& stats : m_filter.dedupStats()) {
+        dedupSent += stats.m_sent;
+        dedupSuppressed += stats.m_suppressed;
+        dedupInfo.append(stats.m_topic + ": " + QString::number(stats.m_suppressed) + " / " + QString::number(stats.m_sent));
+    }
+    m_ui.m_perfDedupLabel->setText(QString::number(dedupSuppressed) + " / " + QString::number(dedupSent));
+    m_ui.m_perfDedupLabel->setToolTip(dedupInfo.join('\n'));
+    m_ui.m_perfShaperLabel->setText(QString::number(m_filter.shaperScale(), 'f', 3));
+
+    unsigned long long rxLimitPassed = 0U;
+    unsigned long long rxLimitDropped = 0U;
+    QStringList rxLimitInfo;
+    for (auto& stats : m_filter.rxLimitStats()) {
+        rxLimitPassed += stats.m_passed;
+        rxLimitDropped += stats.m_dropped;
+        rxLimitInfo.append(stats.m_topic + ": " + QString::number(stats.m_dropped) + " / " + QString::number(stats.m_passed));
+    }
+    m_ui.m_perfRxLimitLabel->setText(QString::number(rxLimitDropped) + " / " + QString::number(rxLimitPassed));
+    m_ui.m_perfRxLimitLabel->setToolTip(rxLimitInfo.join('\n'));
+    m_ui.m_perfRxDuplicatesLabel->setText(QString::number(m_filter.rxDuplicates()));
+    m_ui.m_perfRxExcludedLabel->setText(QString::number(m_filter.rxExcluded()));
+
+    auto rtt = m_filter.rttInfo();
+    m_ui.m_perfSrttLabel->setText(
+        QString::number(rtt.m_srttMs, 'f', 1) + " / " + QString::number(rtt.m_rttVarMs, 'f', 1) + 
+        " (" + QString::number(rtt.m_samples) + ' ' + tr("samples") + ')');
+    m_ui.m_perfRtoLabel->setText(QString::number(rtt.m_retryPeriod));
+
+    if (0.0 < snapshot.m_lastRttMs) {
+        m_rttSparkline->addValue(snapshot.m_lastRttMs);
+    }
+
+    auto probe = m_filter.probeStats();
+    m_ui.m_perfProbeRttLabel->setText(
+        QString::number(probe.m_p50Ms, 'f', 1) + " / " + QString::number(probe.m_p90Ms, 'f', 1) + " / " + QString::number(probe.m_p99Ms, 'f', 1) +
+        " (" + tr("max") + ' ' + QString::number(probe.m_maxMs, 'f', 1) + ')');
+    m_ui.m_perfProbeLossLabel->setText(
+        QString::number(probe.m_lossRate * 100.0, 'f', 1) + "% (" + QString::number(probe.m_lost) + '/' + QString::number(probe.m_sent) + ')');
+
+    m_prevPerf = snapshot;
+
+    m_topicStatsModel->sync();
+    m_ui.m_topicStatsUntrackedLabel->setText(tr("Untracked: %1").arg(m_filter.topicStats().untracked()));
+}
+
+void MqttsnClientFilterConfigWidget::clearTopicStats()
+{
+    m_filter.clearTopicStats();
+    m_topicStatsModel->sync();
+}
+
+void MqttsnClientFilterConfigWidget::exportTopicStats()
+{
+    auto path = QFileDialog::getSaveFileName(this, tr("Export Topic Statistics"), QString(), CsvFilesFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    m_filter.exportTopicStats(path);
+}
+
 void MqttsnClientFilterConfigWidget::refreshPubTopic()
 {
     bool useTopic = (!m_ui.m_pubTopicLineEdit->text().isEmpty());
@@ -200,23 +789,8 @@ void MqttsnClientFilterConfigWidget::refreshPubTopic()
 void MqttsnClientFilterConfigWidget::refreshSubscribes()
 {
     bool subscribesVisible = !m_filter.config().m_subscribes.empty();
-    m_ui.m_subsWidget->setVisible(subscribesVisible);
-}
-
-void MqttsnClientFilterConfigWidget::addSubscribeWidget(SubConfig& config)
-{
-    auto* widget = new MqttsnClientFilterSubConfigWidget(m_filter, config, this);
-    connect(
-        widget, &QObject::destroyed,
-        this,
-        [this](QObject*)
-        {
-            refreshSubscribes();
-        });
-
-    auto* subsLayout = qobject_cast<QVBoxLayout*>(m_ui.m_subsWidget->layout());
-    assert(subsLayout != nullptr);
-    subsLayout->addWidget(widget); 
+    m_ui.m_subsTableView->setVisible(subscribesVisible);
+    m_ui.m_delSubPushButton->setEnabled(m_ui.m_subsTableView->selectionModel()->hasSelection());
 }
 
 }  // namespace cc_plugin_mqttsn_client_filter
@@ -21,7 +21,11 @@
 #include "ui_MqttsnClientFilterConfigWidget.h"
 
 #include "MqttsnClientFilter.h"
+#include "MqttsnClientFilterSparkline.h"
+#include "MqttsnClientFilterSubsModel.h"
+#include "MqttsnClientFilterTopicStatsModel.h"
 
+#include <QtCore/QTimer>
 #include <QtWidgets/QWidget>
 
 
@@ -41,23 +45,69 @@ private slots:
     void refresh();
     void retryPeriodUpdated(int val);
     void retryCountUpdated(int val);
+    void adaptiveRetryUpdated(int val);
+    void minRetryPeriodUpdated(int val);
+    void maxRetryPeriodUpdated(int val);
     void clientIdUpdated(const QString& val);
     void keepAliveUpdated(int val);
     void forcedCleanSessionUpdated(int val);
+    void sessionFileUpdated(const QString& val);
+    void spillDirUpdated(const QString& val);
+    void spillThresholdUpdated(int val);
+    void captureFileUpdated(const QString& val);
+    void streamFramingUpdated(int val);
     void pubTopicUpdated(const QString& val);
     void pubTopicIdUpdated(int val);
     void pubQosUpdated(int val);
+    void pubMaxInFlightUpdated(int val);
+    void pubRateUpdated(int val);
+    void pubBurstUpdated(int val);
+    void topicPubRateUpdated(int val);
+    void coalesceTopicsUpdated(const QString& val);
+    void coalesceWindowUpdated(int val);
+    void coalesceMaxSizeUpdated(int val);
+    void fragmentSizeUpdated(int val);
+    void fragmentWindowUpdated(int val);
+    void reassemblyMaxSizeUpdated(int val);
+    void reassemblyTimeoutUpdated(int val);
+    void reassemblyMaxTotalUpdated(int val);
+    void reassemblyTopicsUpdated(const QString& val);
+    void compressTopicsUpdated(const QString& val);
+    void compressLevelUpdated(int val);
+    void compressMinSizeUpdated(int val);
+    void dedupTopicsUpdated(const QString& val);
+    void dedupHeartbeatUpdated(int val);
+    void dedupDeadbandUpdated(double val);
+    void rxDedupWindowUpdated(int val);
+    void rxDedupTopicsUpdated(const QString& val);
+    void rxExcludeTopicsUpdated(const QString& val);
+    void lastValueCacheSizeUpdated(int val);
+    void lastValueMaxEntrySizeUpdated(int val);
+    void topicStatsLimitUpdated(int val);
+    void probeTopicUpdated(const QString& val);
+    void probeIntervalUpdated(int val);
+    void probeQosUpdated(int val);
     void addSubscribe();
+    void delSubscribes();
+    void importSubscribes();
+    void exportSubscribes();
+    void refreshPerf();
+    void clearTopicStats();
+    void exportTopicStats();
 
 private:
     using SubConfig = MqttsnClientFilter::SubConfig;
 
     void refreshPubTopic();
     void refreshSubscribes();
-    void addSubscribeWidget(SubConfig& config);    
 
     MqttsnClientFilter& m_filter;
     Ui::MqttsnClientFilterConfigWidget m_ui;
+    MqttsnClientFilterSubsModel* m_subsModel = nullptr;
+    MqttsnClientFilterSparkline* m_rttSparkline = nullptr;
+    MqttsnClientFilterTopicStatsModel* m_topicStatsModel = nullptr;
+    QTimer m_perfTimer;
+    MqttsnClientFilter::PerfSnapshot m_prevPerf;
 };
 
 }  // namespace cc_plugin_mqttsn_client_filter
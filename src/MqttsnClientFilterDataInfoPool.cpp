@@ -0,0 +1,75 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterDataInfoPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::size_t MaxProbes = 8U;
+
+} // namespace
+
+MqttsnClientFilterDataInfoPool::MqttsnClientFilterDataInfoPool(std::size_t maxSize, std::size_t payloadCapacity) :
+    m_maxSize(maxSize),
+    m_payloadCapacity(payloadCapacity)
+{
+    m_entries.reserve(maxSize);
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilterDataInfoPool::acquire()
+{
+    // The entries are usually released in the order of acquisition,
+    // the probing continues from the last used position.
+    auto probes = std::min(m_entries.size(), MaxProbes);
+    for (auto idx = 0U; idx < probes; ++idx) {
+        auto& entry = m_entries[m_next];
+        m_next = (m_next + 1U) % m_entries.size();
+        if (entry.use_count() != 1) {
+            continue;
+        }
+
+        ++m_hits;
+        entry->m_timestamp = decltype(entry->m_timestamp)::clock::now();
+        entry->m_data.clear();
+        entry->m_extraProperties.clear();
+        return entry;
+    }
+
+    ++m_misses;
+    auto result = cc_tools_qt::makeDataInfoTimed();
+    result->m_data.reserve(m_payloadCapacity);
+    if (m_entries.size() < m_maxSize) {
+        m_entries.push_back(result);
+    }
+
+    return result;
+}
+
+void MqttsnClientFilterDataInfoPool::clear()
+{
+    m_entries.clear();
+    m_next = 0U;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,68 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cc_tools_qt/DataInfo.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Recycling pool of the DataInfo objects. The pooled object is reused
+// when nobody else holds a reference to it anymore, keeping the capacity 
+// of its payload buffer. Only a few entries are probed on every request,
+// a new object is allocated when none of them is free.
+class MqttsnClientFilterDataInfoPool
+{
+public:
+    struct Stats
+    {
+        unsigned long long m_hits = 0U;
+        unsigned long long m_misses = 0U;
+        std::size_t m_size = 0U;
+    };
+
+    MqttsnClientFilterDataInfoPool(std::size_t maxSize, std::size_t payloadCapacity);
+
+    cc_tools_qt::DataInfoPtr acquire();
+    void clear();
+
+    Stats stats() const
+    {
+        Stats result;
+        result.m_hits = m_hits;
+        result.m_misses = m_misses;
+        result.m_size = m_entries.size();
+        return result;
+    }
+
+private:
+    std::vector<cc_tools_qt::DataInfoPtr> m_entries;
+    std::size_t m_maxSize = 0U;
+    std::size_t m_payloadCapacity = 0U;
+    std::size_t m_next = 0U;
+    unsigned long long m_hits = 0U;
+    unsigned long long m_misses = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
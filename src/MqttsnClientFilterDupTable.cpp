@@ -0,0 +1,89 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterDupTable.h"
+
+#include <algorithm>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::size_t MaxProbes = 8U;
+
+std::size_t roundUpPow2(std::size_t value)
+{
+    std::size_t result = 1U;
+    while (result < value) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+} // namespace
+
+MqttsnClientFilterDupTable::MqttsnClientFilterDupTable(std::size_t capacity) :
+    m_entries(roundUpPow2(std::max(capacity, MaxProbes))),
+    m_mask(m_entries.size() - 1U)
+{
+}
+
+void MqttsnClientFilterDupTable::setWindow(unsigned windowMs)
+{
+    m_windowUs = static_cast<qint64>(windowMs) * 1000;
+}
+
+void MqttsnClientFilterDupTable::clear()
+{
+    std::fill(m_entries.begin(), m_entries.end(), Entry());
+}
+
+bool MqttsnClientFilterDupTable::checkAndInsert(std::uint64_t hash, qint64 nowUs)
+{
+    Entry* freeEntry = nullptr;
+    Entry* oldestEntry = nullptr;
+    auto idx = static_cast<std::size_t>(hash) & m_mask;
+    for (auto probe = 0U; probe < MaxProbes; ++probe) {
+        auto& entry = m_entries[(idx + probe) & m_mask];
+        bool expired = (entry.m_expiryUs <= nowUs);
+        if ((!expired) && (entry.m_hash == hash)) {
+            return true;
+        }
+
+        if (expired && (freeEntry == nullptr)) {
+            freeEntry = &entry;
+        }
+
+        if ((oldestEntry == nullptr) || (entry.m_expiryUs < oldestEntry->m_expiryUs)) {
+            oldestEntry = &entry;
+        }
+
+        if (entry.m_expiryUs == 0) {
+            // Never used, the hash cannot be further in the chain
+            break;
+        }
+    }
+
+    auto* target = (freeEntry != nullptr) ? freeEntry : oldestEntry;
+    target->m_hash = hash;
+    target->m_expiryUs = nowUs + m_windowUs;
+    return false;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,58 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Fixed size open addressing (linear probing) table of recently seen
+// message hashes. The entries expire after the configured window and 
+// the oldest probed entry is overwritten when the table is congested.
+class MqttsnClientFilterDupTable
+{
+public:
+    explicit MqttsnClientFilterDupTable(std::size_t capacity);
+
+    void setWindow(unsigned windowMs);
+    void clear();
+
+    // Returns true if the hash has been seen within the window, records it otherwise
+    bool checkAndInsert(std::uint64_t hash, qint64 nowUs);
+
+private:
+    struct Entry
+    {
+        std::uint64_t m_hash = 0U;
+        qint64 m_expiryUs = 0;
+    };
+
+    std::vector<Entry> m_entries;
+    std::size_t m_mask = 0U;
+    qint64 m_windowUs = 0;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
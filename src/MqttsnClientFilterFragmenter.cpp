@@ -0,0 +1,268 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterFragmenter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::uint8_t Marker[] = {0xcc, 0x02};
+const std::size_t MarkerLen = std::extent<decltype(Marker)>::value;
+const std::size_t HeaderLen = MarkerLen + 2U + 4U + 4U;
+const std::size_t MaxCompleted = 64U;
+
+std::uint32_t readU32(const std::uint8_t* data)
+{
+    return
+        (static_cast<std::uint32_t>(data[0]) << 24U) |
+        (static_cast<std::uint32_t>(data[1]) << 16U) |
+        (static_cast<std::uint32_t>(data[2]) << 8U) |
+        static_cast<std::uint32_t>(data[3]);
+}
+
+void writeU32(std::uint32_t value, MqttsnClientFilterFragmenter::DataBuf& buf)
+{
+    buf.push_back(static_cast<std::uint8_t>((value >> 24U) & 0xff));
+    buf.push_back(static_cast<std::uint8_t>((value >> 16U) & 0xff));
+    buf.push_back(static_cast<std::uint8_t>((value >> 8U) & 0xff));
+    buf.push_back(static_cast<std::uint8_t>(value & 0xff));
+}
+
+} // namespace
+
+std::size_t MqttsnClientFilterFragmenter::headerLen()
+{
+    return HeaderLen;
+}
+
+bool MqttsnClientFilterFragmenter::split(const cc_tools_qt::DataInfo& info, std::size_t fragmentSize)
+{
+    auto& data = info.m_data;
+    if ((fragmentSize <= HeaderLen) || (std::numeric_limits<std::uint32_t>::max() < data.size())) {
+        return false;
+    }
+
+    auto chunkLen = fragmentSize - HeaderLen;
+    auto msgId = m_nextMsgId & 0xffff;
+    ++m_nextMsgId;
+
+    for (std::size_t offset = 0U; offset < data.size(); offset += chunkLen) {
+        auto len = std::min(chunkLen, data.size() - offset);
+        auto fragment = cc_tools_qt::makeDataInfoTimed();
+        fragment->m_extraProperties = info.m_extraProperties;
+
+        auto& buf = fragment->m_data;
+        buf.reserve(HeaderLen + len);
+        buf.assign(std::begin(Marker), std::end(Marker));
+        buf.push_back(static_cast<std::uint8_t>((msgId >> 8U) & 0xff));
+        buf.push_back(static_cast<std::uint8_t>(msgId & 0xff));
+        writeU32(static_cast<std::uint32_t>(offset), buf);
+        writeU32(static_cast<std::uint32_t>(data.size()), buf);
+        buf.insert(buf.end(), data.begin() + static_cast<std::ptrdiff_t>(offset), data.begin() + static_cast<std::ptrdiff_t>(offset + len));
+        m_pending.push_back(std::move(fragment));
+    }
+
+    return true;
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilterFragmenter::takeNext()
+{
+    if (m_pending.empty()) {
+        return cc_tools_qt::DataInfoPtr();
+    }
+
+    auto result = std::move(m_pending.front());
+    m_pending.pop_front();
+    return result;
+}
+
+void MqttsnClientFilterFragmenter::setReassemblyLimits(std::size_t maxSize, std::size_t maxTotal, unsigned timeoutMs)
+{
+    m_maxSize = maxSize;
+    m_maxTotal = maxTotal;
+    m_timeoutUs = static_cast<qint64>(timeoutMs) * 1000;
+}
+
+MqttsnClientFilterFragmenter::ReassembleResult MqttsnClientFilterFragmenter::reassemble(
+    std::string_view topic, 
+    const std::uint8_t* data, 
+    std::size_t len, 
+    qint64 nowUs, 
+    DataBuf& out)
+{
+    if ((len < HeaderLen) || (!std::equal(std::begin(Marker), std::end(Marker), data))) {
+        return ReassembleResult_NotFragment;
+    }
+
+    dropExpired(nowUs);
+
+    auto msgId = (static_cast<unsigned>(data[2]) << 8U) | static_cast<unsigned>(data[3]);
+    auto offset = readU32(data + 4);
+    auto totalLen = static_cast<std::size_t>(readU32(data + 8));
+    auto* chunk = data + HeaderLen;
+    auto chunkLen = len - HeaderLen;
+    if ((chunkLen == 0U) || (totalLen < offset) || ((totalLen - offset) < chunkLen)) {
+        return ReassembleResult_Dropped;
+    }
+
+    std::string key(topic);
+    key += '\n';
+    key += std::to_string(msgId);
+
+    if (m_completed.find(key) != m_completed.end()) {
+        // Late or duplicate fragment of the already reassembled message
+        return ReassembleResult_Incomplete;
+    }
+
+    auto iter = m_partials.find(key);
+    if ((iter != m_partials.end()) && (iter->second.m_totalLen != totalLen)) {
+        // Message ID has been reused
+        erasePartial(iter);
+        iter = m_partials.end();
+    }
+
+    if (iter == m_partials.end()) {
+        if (!reserve(totalLen)) {
+            return ReassembleResult_Dropped;
+        }
+
+        Partial partial;
+        partial.m_data.resize(totalLen);
+        partial.m_totalLen = totalLen;
+        partial.m_startUs = nowUs;
+        iter = m_partials.emplace(key, std::move(partial)).first;
+        m_partialsSize += totalLen;
+    }
+
+    auto& partial = iter->second;
+    auto added = addRange(partial, offset, offset + chunkLen);
+    if (added == 0U) {
+        // Duplicate fragment
+        return ReassembleResult_Incomplete;
+    }
+
+    std::copy_n(chunk, chunkLen, partial.m_data.begin() + static_cast<std::ptrdiff_t>(offset));
+    partial.m_received += added;
+    if (partial.m_received < totalLen) {
+        return ReassembleResult_Incomplete;
+    }
+
+    out = std::move(partial.m_data);
+    erasePartial(iter);
+    addCompleted(std::move(key));
+    return ReassembleResult_Complete;
+}
+
+std::size_t MqttsnClientFilterFragmenter::addRange(Partial& partial, std::size_t begin, std::size_t end)
+{
+    assert(begin < end);
+    auto& ranges = partial.m_ranges;
+
+    // The range is merged with all the overlapping or adjacent ones, only the newly
+    // covered bytes are accounted.
+    auto iter = ranges.upper_bound(begin);
+    if ((iter != ranges.begin()) && (begin <= std::prev(iter)->second)) {
+        --iter;
+    }
+
+    auto newBegin = begin;
+    auto newEnd = end;
+    std::size_t covered = 0U;
+    while ((iter != ranges.end()) && (iter->first <= end)) {
+        auto overlapBegin = std::max(begin, iter->first);
+        auto overlapEnd = std::min(end, iter->second);
+        if (overlapBegin < overlapEnd) {
+            covered += overlapEnd - overlapBegin;
+        }
+
+        newBegin = std::min(newBegin, iter->first);
+        newEnd = std::max(newEnd, iter->second);
+        iter = ranges.erase(iter);
+    }
+
+    ranges[newBegin] = newEnd;
+    return (end - begin) - covered;
+}
+
+void MqttsnClientFilterFragmenter::dropExpired(qint64 nowUs)
+{
+    if (m_timeoutUs == 0) {
+        return;
+    }
+
+    for (auto iter = m_partials.begin(); iter != m_partials.end(); ) {
+        if ((nowUs - iter->second.m_startUs) < m_timeoutUs) {
+            ++iter;
+            continue;
+        }
+
+        erasePartial(iter++);
+    }
+}
+
+bool MqttsnClientFilterFragmenter::reserve(std::size_t len)
+{
+    if (((0U < m_maxSize) && (m_maxSize < len)) || 
+        ((0U < m_maxTotal) && (m_maxTotal < len))) {
+        return false;
+    }
+
+    // The oldest incomplete messages are evicted to stay within the limit
+    while ((0U < m_maxTotal) && (m_maxTotal < (m_partialsSize + len)) && (!m_partials.empty())) {
+        auto oldest = 
+            std::min_element(
+                m_partials.begin(), m_partials.end(),
+                [](auto& first, auto& second)
+                {
+                    return first.second.m_startUs < second.second.m_startUs;
+                });
+
+        erasePartial(oldest);
+    }
+
+    return true;
+}
+
+void MqttsnClientFilterFragmenter::erasePartial(PartialsMap::iterator iter)
+{
+    m_partialsSize -= std::min(m_partialsSize, iter->second.m_totalLen);
+    m_partials.erase(iter);
+}
+
+void MqttsnClientFilterFragmenter::addCompleted(std::string key)
+{
+    if (MaxCompleted <= m_completedOrder.size()) {
+        m_completed.erase(m_completedOrder.front());
+        m_completedOrder.pop_front();
+    }
+
+    auto result = m_completed.insert(std::move(key));
+    if (result.second) {
+        m_completedOrder.push_back(result.first);
+    }
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,100 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cc_tools_qt/DataInfo.h>
+
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Splits the large payloads into sequenced fragments and reassembles them 
+// on the receiving side. Every fragment starts with the 12 bytes header: 
+// 0xcc 0x02 marker, u16 message ID, u32 offset and u32 total length.
+// The message is complete when the received byte ranges cover all of it.
+// The late fragments of the recently completed messages are ignored.
+class MqttsnClientFilterFragmenter
+{
+public:
+    enum ReassembleResult
+    {
+        ReassembleResult_NotFragment,
+        ReassembleResult_Incomplete,
+        ReassembleResult_Complete,
+        ReassembleResult_Dropped,
+    };
+
+    using DataBuf = std::vector<std::uint8_t>;
+
+    static std::size_t headerLen();
+
+    bool split(const cc_tools_qt::DataInfo& info, std::size_t fragmentSize);
+    cc_tools_qt::DataInfoPtr takeNext();
+
+    bool hasPending() const
+    {
+        return !m_pending.empty();
+    }
+
+    void setReassemblyLimits(std::size_t maxSize, std::size_t maxTotal, unsigned timeoutMs);
+    ReassembleResult reassemble(std::string_view topic, const std::uint8_t* data, std::size_t len, qint64 nowUs, DataBuf& out);
+
+private:
+    struct Partial
+    {
+        DataBuf m_data;
+        std::map<std::size_t, std::size_t> m_ranges; // begin -> end of the received bytes
+        std::size_t m_totalLen = 0U;
+        std::size_t m_received = 0U;
+        qint64 m_startUs = 0;
+    };
+
+    using PartialsMap = std::map<std::string, Partial>;
+    using CompletedSet = std::set<std::string>;
+
+    static std::size_t addRange(Partial& partial, std::size_t begin, std::size_t end);
+    void dropExpired(qint64 nowUs);
+    bool reserve(std::size_t len);
+    void erasePartial(PartialsMap::iterator iter);
+    void addCompleted(std::string key);
+
+    std::deque<cc_tools_qt::DataInfoPtr> m_pending;
+    PartialsMap m_partials;
+    std::size_t m_partialsSize = 0U;
+    CompletedSet m_completed;
+    std::deque<CompletedSet::iterator> m_completedOrder;
+    std::size_t m_maxSize = 0U;
+    std::size_t m_maxTotal = 0U;
+    qint64 m_timeoutUs = 0;
+    unsigned m_nextMsgId = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,93 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterFramer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+// The length is encoded in 3 bytes when the first one is 0x01
+const std::uint8_t LongLengthMarker = 0x01;
+const std::size_t ShortHeaderLen = 1U;
+const std::size_t LongHeaderLen = 3U;
+
+} // namespace
+
+void MqttsnClientFilterFramer::reset()
+{
+    m_partial.clear();
+    m_resync.clear();
+}
+
+MqttsnClientFilterFramer::LengthResult MqttsnClientFilterFramer::frameLength(const std::uint8_t* data, std::size_t dataLen, std::size_t& frameLen)
+{
+    if (dataLen == 0U) {
+        return LengthResult_Incomplete;
+    }
+
+    // The frame must contain at least the message type following the length
+    if (data[0] != LongLengthMarker) {
+        frameLen = data[0];
+        return (ShortHeaderLen < frameLen) ? LengthResult_Valid : LengthResult_Invalid;
+    }
+
+    if (dataLen < LongHeaderLen) {
+        return LengthResult_Incomplete;
+    }
+
+    frameLen = (static_cast<std::size_t>(data[1]) << 8U) | static_cast<std::size_t>(data[2]);
+    return (LongHeaderLen < frameLen) ? LengthResult_Valid : LengthResult_Invalid;
+}
+
+MqttsnClientFilterFramer::FillStatus MqttsnClientFilterFramer::fillPartial(const std::uint8_t*& pos, const std::uint8_t* end)
+{
+    assert(!m_partial.empty());
+    std::size_t frameLen = 0U;
+    auto result = frameLength(m_partial.data(), m_partial.size(), frameLen);
+    if (result == LengthResult_Incomplete) {
+        auto headerRem = std::min(LongHeaderLen - m_partial.size(), static_cast<std::size_t>(end - pos));
+        m_partial.insert(m_partial.end(), pos, pos + headerRem);
+        pos += headerRem;
+        result = frameLength(m_partial.data(), m_partial.size(), frameLen);
+    }
+
+    if (result == LengthResult_Incomplete) {
+        return FillStatus_Incomplete;
+    }
+
+    if (result == LengthResult_Invalid) {
+        return FillStatus_Resync;
+    }
+
+    assert(m_partial.size() < frameLen);
+    auto frameRem = std::min(frameLen - m_partial.size(), static_cast<std::size_t>(end - pos));
+    m_partial.insert(m_partial.end(), pos, pos + frameRem);
+    pos += frameRem;
+    if (m_partial.size() < frameLen) {
+        return FillStatus_Incomplete;
+    }
+
+    return FillStatus_Complete;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
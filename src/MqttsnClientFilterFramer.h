@@ -0,0 +1,129 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Splits the stream of bytes into the MQTT-SN frames using the length
+// field of the message header. The complete frames are reported directly
+// from the input buffer, only the trailing incomplete frame is buffered 
+// until the rest of it is received. The bytes which cannot start a valid
+// frame are discarded one at a time until the stream is resynchronised.
+class MqttsnClientFilterFramer
+{
+public:
+    void reset();
+
+    unsigned long long discarded() const
+    {
+        return m_discarded;
+    }
+
+    std::size_t buffered() const
+    {
+        return m_partial.size();
+    }
+
+    template <typename TFunc>
+    void feed(const std::uint8_t* data, std::size_t dataLen, TFunc&& func)
+    {
+        auto* pos = data;
+        auto* end = data + dataLen;
+        if (!m_partial.empty()) {
+            auto status = fillPartial(pos, end);
+            if (status == FillStatus_Incomplete) {
+                return;
+            }
+
+            if (status == FillStatus_Resync) {
+                // Rare case of the corrupted buffered header, the remaining
+                // bytes are parsed again together with the rest of the input.
+                m_resync.assign(m_partial.begin() + 1, m_partial.end());
+                m_resync.insert(m_resync.end(), pos, end);
+                m_partial.clear();
+                ++m_discarded;
+                const std::uint8_t* resyncEnd = m_resync.data() + m_resync.size();
+                auto* resyncPos = consume(m_resync.data(), resyncEnd, func);
+                m_partial.assign(resyncPos, resyncEnd);
+                return;
+            }
+
+            func(m_partial.data(), m_partial.size());
+            m_partial.clear();
+        }
+
+        pos = consume(pos, end, func);
+        m_partial.assign(pos, end);
+    }
+
+private:
+    enum LengthResult
+    {
+        LengthResult_Valid,
+        LengthResult_Incomplete,
+        LengthResult_Invalid
+    };
+
+    enum FillStatus
+    {
+        FillStatus_Complete,
+        FillStatus_Incomplete,
+        FillStatus_Resync
+    };
+
+    static LengthResult frameLength(const std::uint8_t* data, std::size_t dataLen, std::size_t& frameLen);
+    FillStatus fillPartial(const std::uint8_t*& pos, const std::uint8_t* end);
+
+    template <typename TFunc>
+    const std::uint8_t* consume(const std::uint8_t* pos, const std::uint8_t* end, TFunc& func)
+    {
+        while (pos < end) {
+            std::size_t frameLen = 0U;
+            auto remLen = static_cast<std::size_t>(end - pos);
+            auto result = frameLength(pos, remLen, frameLen);
+            if (result == LengthResult_Invalid) {
+                ++m_discarded;
+                ++pos;
+                continue;
+            }
+
+            if ((result == LengthResult_Incomplete) || (remLen < frameLen)) {
+                break;
+            }
+
+            func(pos, frameLen);
+            pos += frameLen;
+        }
+
+        return pos;
+    }
+
+    std::vector<std::uint8_t> m_partial;
+    std::vector<std::uint8_t> m_resync;
+    unsigned long long m_discarded = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
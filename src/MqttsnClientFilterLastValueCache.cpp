@@ -0,0 +1,106 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterLastValueCache.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+MqttsnClientFilterLastValueCache::MqttsnClientFilterLastValueCache() = default;
+MqttsnClientFilterLastValueCache::~MqttsnClientFilterLastValueCache() noexcept = default;
+
+void MqttsnClientFilterLastValueCache::setLimits(std::size_t maxSize, std::size_t maxEntrySize)
+{
+    m_maxSize = maxSize;
+    m_maxEntrySize = maxEntrySize;
+
+    if (!isEnabled()) {
+        clear();
+        return;
+    }
+
+    evictInternal();
+}
+
+void MqttsnClientFilterLastValueCache::clear()
+{
+    m_map.clear();
+    m_entries.clear();
+    m_totalSize = 0U;
+}
+
+void MqttsnClientFilterLastValueCache::update(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    auto mapIter = m_map.find(std::string_view(topic));
+    if ((0U < m_maxEntrySize) && (m_maxEntrySize < dataLen)) {
+        // The stale value must not be reported as the latest one
+        if (mapIter != m_map.end()) {
+            m_totalSize -= entrySize(*mapIter->second);
+            m_entries.erase(mapIter->second);
+            m_map.erase(mapIter);
+        }
+        return;
+    }
+
+    if (mapIter == m_map.end()) {
+        m_entries.emplace_back();
+        auto entryIter = std::prev(m_entries.end());
+        entryIter->m_topic = topic;
+        mapIter = m_map.emplace(entryIter->m_topic, entryIter).first;
+    }
+    else {
+        m_totalSize -= entrySize(*mapIter->second);
+        m_entries.splice(m_entries.end(), m_entries, mapIter->second);
+    }
+
+    auto& entry = *mapIter->second;
+
+    // Reuses the payload buffer unless it is still shared with a snapshot
+    entry.m_payload.resize(static_cast<int>(dataLen));
+    if (0U < dataLen) {
+        std::memcpy(entry.m_payload.data(), data, dataLen);
+    }
+
+    entry.m_qos = qos;
+    entry.m_retained = retained;
+    m_totalSize += entrySize(entry);
+    evictInternal();
+}
+
+std::size_t MqttsnClientFilterLastValueCache::entrySize(const Entry& entry)
+{
+    return entry.m_topic.size() + static_cast<std::size_t>(entry.m_payload.size());
+}
+
+void MqttsnClientFilterLastValueCache::evictInternal()
+{
+    while ((m_maxSize < m_totalSize) && (!m_entries.empty())) {
+        auto& entry = m_entries.front();
+        m_totalSize -= entrySize(entry);
+        m_map.erase(entry.m_topic);
+        m_entries.pop_front();
+    }
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,90 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QByteArray>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Memory bounded cache of the last payload received on every topic.
+// The entries are kept in the least recently updated order and the
+// oldest ones are evicted when the total size exceeds the limit.
+// The payloads are implicitly shared with the produced snapshots.
+class MqttsnClientFilterLastValueCache
+{
+public:
+    struct Entry
+    {
+        std::string m_topic;
+        QByteArray m_payload;
+        int m_qos = 0;
+        bool m_retained = false;
+    };
+
+    using EntriesList = std::list<Entry>;
+
+    MqttsnClientFilterLastValueCache();
+    ~MqttsnClientFilterLastValueCache() noexcept;
+
+    void setLimits(std::size_t maxSize, std::size_t maxEntrySize);
+    void clear();
+
+    bool isEnabled() const
+    {
+        return 0U < m_maxSize;
+    }
+
+    void update(const char* topic, const std::uint8_t* data, std::size_t dataLen, int qos, bool retained);
+
+    // From the least to the most recently updated
+    const EntriesList& entries() const
+    {
+        return m_entries;
+    }
+
+    std::size_t totalSize() const
+    {
+        return m_totalSize;
+    }
+
+private:
+    // The keys refer to the topics stored in the (node stable) entries list
+    using EntriesMap = std::map<std::string_view, EntriesList::iterator>;
+
+    static std::size_t entrySize(const Entry& entry);
+    void evictInternal();
+
+    EntriesList m_entries;
+    EntriesMap m_map;
+    std::size_t m_maxSize = 0U;
+    std::size_t m_maxEntrySize = 0U;
+    std::size_t m_totalSize = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,187 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterProbe.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::uint8_t Magic[] = {'C', 'C', 'P', 'R'};
+const std::size_t MagicLen = std::extent<decltype(Magic)>::value;
+const std::size_t ProbeLen = MagicLen + 4U + 4U + 8U;
+const std::size_t MaxSamples = 1024U;
+const std::size_t MaxPending = 1024U;
+
+std::uint64_t readBe(const std::uint8_t* data, std::size_t len)
+{
+    std::uint64_t result = 0U;
+    for (auto idx = 0U; idx < len; ++idx) {
+        result = (result << 8U) | data[idx];
+    }
+    return result;
+}
+
+void writeBe(std::uint64_t value, std::size_t len, MqttsnClientFilterProbe::DataBuf& buf)
+{
+    for (auto idx = len; 0U < idx; --idx) {
+        buf.push_back(static_cast<std::uint8_t>((value >> ((idx - 1U) * 8U)) & 0xff));
+    }
+}
+
+double percentile(std::vector<double>& values, double ratio)
+{
+    assert(!values.empty());
+    auto idx = static_cast<std::size_t>(ratio * static_cast<double>(values.size() - 1U));
+    auto iter = values.begin() + static_cast<std::ptrdiff_t>(idx);
+    std::nth_element(values.begin(), iter, values.end());
+    return *iter;
+}
+
+} // namespace
+
+MqttsnClientFilterProbe::MqttsnClientFilterProbe()
+{
+    // The tag distinguishes own probes from the ones published by other
+    // clients to the same loopback topic.
+    std::random_device rd;
+    m_tag = static_cast<std::uint32_t>(rd());
+    m_samples.reserve(MaxSamples);
+}
+
+void MqttsnClientFilterProbe::reset()
+{
+    m_pending.clear();
+    m_samples.clear();
+    m_nextSample = 0U;
+    m_sent = 0U;
+    m_received = 0U;
+    m_lost = 0U;
+    m_lastMs = 0.0;
+    m_minMs = 0.0;
+    m_maxMs = 0.0;
+    m_sumMs = 0.0;
+}
+
+void MqttsnClientFilterProbe::makeProbe(qint64 nowUs, DataBuf& buf) const
+{
+    buf.clear();
+    buf.reserve(ProbeLen);
+    buf.insert(buf.end(), std::begin(Magic), std::end(Magic));
+    writeBe(m_tag, 4U, buf);
+    writeBe(m_nextSeq, 4U, buf);
+    writeBe(static_cast<std::uint64_t>(nowUs), 8U, buf);
+}
+
+void MqttsnClientFilterProbe::markSent(qint64 nowUs)
+{
+    if (MaxPending <= m_pending.size()) {
+        m_pending.erase(m_pending.begin());
+        ++m_lost;
+    }
+
+    m_pending[m_nextSeq] = nowUs;
+    ++m_nextSeq;
+    ++m_sent;
+}
+
+bool MqttsnClientFilterProbe::match(const std::uint8_t* data, std::size_t dataLen, qint64 nowUs)
+{
+    if ((dataLen != ProbeLen) ||
+        (!std::equal(std::begin(Magic), std::end(Magic), data)) ||
+        (readBe(data + MagicLen, 4U) != m_tag)) {
+        return false;
+    }
+
+    auto seq = static_cast<std::uint32_t>(readBe(data + MagicLen + 4U, 4U));
+    auto sentUs = static_cast<qint64>(readBe(data + MagicLen + 8U, 8U));
+    auto iter = m_pending.find(seq);
+    if ((iter == m_pending.end()) || (iter->second != sentUs)) {
+        // Duplicate or already accounted as lost
+        return true;
+    }
+
+    m_pending.erase(iter);
+    ++m_received;
+    addSample(static_cast<double>(std::max(qint64(0), nowUs - sentUs)) / 1000.0);
+    return true;
+}
+
+void MqttsnClientFilterProbe::expire(qint64 nowUs, qint64 timeoutUs)
+{
+    while ((!m_pending.empty()) && (timeoutUs <= (nowUs - m_pending.begin()->second))) {
+        m_pending.erase(m_pending.begin());
+        ++m_lost;
+    }
+}
+
+MqttsnClientFilterProbe::Stats MqttsnClientFilterProbe::stats() const
+{
+    Stats result;
+    result.m_sent = m_sent;
+    result.m_received = m_received;
+    result.m_lost = m_lost;
+    auto completed = m_received + m_lost;
+    if (0U < completed) {
+        result.m_lossRate = static_cast<double>(m_lost) / static_cast<double>(completed);
+    }
+
+    if (m_received == 0U) {
+        return result;
+    }
+
+    result.m_lastMs = m_lastMs;
+    result.m_minMs = m_minMs;
+    result.m_meanMs = m_sumMs / static_cast<double>(m_received);
+    result.m_maxMs = m_maxMs;
+
+    // The percentiles are calculated over the most recent samples only
+    auto samples = m_samples;
+    result.m_p50Ms = percentile(samples, 0.5);
+    result.m_p90Ms = percentile(samples, 0.9);
+    result.m_p99Ms = percentile(samples, 0.99);
+    return result;
+}
+
+void MqttsnClientFilterProbe::addSample(double rttMs)
+{
+    if (m_samples.size() < MaxSamples) {
+        m_samples.push_back(rttMs);
+    }
+    else {
+        m_samples[m_nextSample] = rttMs;
+        m_nextSample = (m_nextSample + 1U) % MaxSamples;
+    }
+
+    if ((m_received == 1U) || (rttMs < m_minMs)) {
+        m_minMs = rttMs;
+    }
+
+    m_maxMs = std::max(m_maxMs, rttMs);
+    m_sumMs += rttMs;
+    m_lastMs = rttMs;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,83 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Round trip measurement by the probe messages published to the loopback
+// topic and echoed back by the gateway. The probe payload carries the tag
+// of the instance, the sequence number and the send timestamp. The probe
+// not echoed back within the timeout is accounted as lost.
+class MqttsnClientFilterProbe
+{
+public:
+    using DataBuf = std::vector<std::uint8_t>;
+
+    struct Stats
+    {
+        unsigned long long m_sent = 0U;
+        unsigned long long m_received = 0U;
+        unsigned long long m_lost = 0U;
+        double m_lossRate = 0.0;
+        double m_lastMs = 0.0;
+        double m_minMs = 0.0;
+        double m_meanMs = 0.0;
+        double m_maxMs = 0.0;
+        double m_p50Ms = 0.0;
+        double m_p90Ms = 0.0;
+        double m_p99Ms = 0.0;
+    };
+
+    MqttsnClientFilterProbe();
+
+    void reset();
+    void makeProbe(qint64 nowUs, DataBuf& buf) const;
+    void markSent(qint64 nowUs);
+    bool match(const std::uint8_t* data, std::size_t dataLen, qint64 nowUs);
+    void expire(qint64 nowUs, qint64 timeoutUs);
+    Stats stats() const;
+
+private:
+    void addSample(double rttMs);
+
+    std::uint32_t m_tag = 0U;
+    std::uint32_t m_nextSeq = 0U;
+    std::map<std::uint32_t, qint64> m_pending;
+    std::vector<double> m_samples;
+    std::size_t m_nextSample = 0U;
+    unsigned long long m_sent = 0U;
+    unsigned long long m_received = 0U;
+    unsigned long long m_lost = 0U;
+    double m_lastMs = 0.0;
+    double m_minMs = 0.0;
+    double m_maxMs = 0.0;
+    double m_sumMs = 0.0;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
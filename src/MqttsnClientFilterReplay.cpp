@@ -0,0 +1,178 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterReplay.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+// Records fed in one event loop iteration when replaying as fast as possible,
+// gives the filter timers a chance to run.
+const unsigned MaxBatch = 1024U;
+
+} // namespace
+
+MqttsnClientFilterReplay::MqttsnClientFilterReplay(MqttsnClientFilter& filter, QObject* parentObj) :
+    QObject(parentObj),
+    m_filter(filter)
+{
+    m_timer.setSingleShot(true);
+    connect(
+        &m_timer, &QTimer::timeout,
+        this, &MqttsnClientFilterReplay::step);
+}
+
+MqttsnClientFilterReplay::~MqttsnClientFilterReplay() noexcept = default;
+
+bool MqttsnClientFilterReplay::start(const QString& path, double speed)
+{
+    if (!m_capture.load(path)) {
+        return false;
+    }
+
+    m_expected.clear();
+    Record record;
+    while (m_capture.readNext(record)) {
+        if (record.m_direction == MqttsnClientFilterCapture::Direction_Out) {
+            m_expected.push_back(record);
+        }
+    }
+
+    m_capture.rewind();
+    m_expectedIdx = 0U;
+    m_report = Report();
+    m_speed = std::max(speed, 0.0);
+    m_hasNext = readInputInternal();
+
+    m_filter.setDataToSendCallback(
+        [this](cc_tools_qt::DataInfoPtr dataPtr)
+        {
+            assert(dataPtr);
+            outputInternal(*dataPtr);
+        });
+
+    // The capture timestamps are relative to the filter start
+    m_startTs = std::chrono::steady_clock::now();
+    if (!m_filter.start()) {
+        return false;
+    }
+
+    m_filter.socketConnectionReport(true);
+    m_timer.start(0);
+    return true;
+}
+
+void MqttsnClientFilterReplay::step()
+{
+    unsigned count = 0U;
+    while (m_hasNext) {
+        if (0.0 < m_speed) {
+            auto dueUs = static_cast<qint64>(static_cast<double>(m_next.m_timestampUs) / m_speed);
+            auto nowUs = elapsedUs();
+            if (nowUs < dueUs) {
+                m_timer.start(static_cast<int>(std::ceil(static_cast<double>(dueUs - nowUs) / 1000.0)));
+                return;
+            }
+        }
+        else if (MaxBatch <= count) {
+            m_timer.start(0);
+            return;
+        }
+
+        feedInternal(m_next);
+        ++count;
+        m_hasNext = readInputInternal();
+    }
+
+    m_report.m_elapsedUs = elapsedUs();
+    m_report.m_missing = m_expected.size() - std::min(m_expectedIdx, m_expected.size());
+    emit sigFinished();
+}
+
+bool MqttsnClientFilterReplay::readInputInternal()
+{
+    while (m_capture.readNext(m_next)) {
+        if (m_next.m_direction != MqttsnClientFilterCapture::Direction_Out) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MqttsnClientFilterReplay::feedInternal(const Record& record)
+{
+    auto startTs = std::chrono::steady_clock::now();
+    m_report.m_bytes += record.m_dataLen;
+    if (record.m_direction == MqttsnClientFilterCapture::Direction_In) {
+        ++m_report.m_inFrames;
+        auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+        dataPtr->m_data.assign(record.m_data, record.m_data + record.m_dataLen);
+        auto delivered = m_filter.recvData(std::move(dataPtr));
+        m_report.m_delivered += static_cast<unsigned long long>(delivered.size());
+    }
+    else {
+        assert(record.m_direction == MqttsnClientFilterCapture::Direction_Publish);
+        auto dataPtr = MqttsnClientFilterCapture::decodePublish(record);
+        if (dataPtr) {
+            ++m_report.m_publishes;
+            auto toSend = m_filter.sendData(std::move(dataPtr));
+            for (auto& sendPtr : toSend) {
+                outputInternal(*sendPtr);
+            }
+        }
+    }
+
+    m_report.m_busyUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTs).count();
+}
+
+void MqttsnClientFilterReplay::outputInternal(const cc_tools_qt::DataInfo& info)
+{
+    ++m_report.m_outFrames;
+    if (m_expected.size() <= m_expectedIdx) {
+        ++m_report.m_extra;
+        return;
+    }
+
+    auto& expected = m_expected[m_expectedIdx];
+    ++m_expectedIdx;
+
+    bool matches =
+        (expected.m_dataLen == info.m_data.size()) &&
+        (std::equal(info.m_data.begin(), info.m_data.end(), expected.m_data));
+
+    if (matches) {
+        ++m_report.m_matched;
+        return;
+    }
+
+    ++m_report.m_mismatched;
+}
+
+qint64 MqttsnClientFilterReplay::elapsedUs() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTs).count();
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,97 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+#include "MqttsnClientFilterCapture.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <chrono>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Feeds the recorded capture back through the filter. The received frames
+// and the messages to publish are replayed at the original pace scaled by
+// the speed factor (0 means as fast as possible), while the frames produced
+// by the filter are compared with the recorded ones in order.
+class MqttsnClientFilterReplay : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Report
+    {
+        unsigned long long m_inFrames = 0U;
+        unsigned long long m_publishes = 0U;
+        unsigned long long m_bytes = 0U;
+        unsigned long long m_delivered = 0U;
+        unsigned long long m_outFrames = 0U;
+        unsigned long long m_matched = 0U;
+        unsigned long long m_mismatched = 0U;
+        unsigned long long m_missing = 0U;
+        unsigned long long m_extra = 0U;
+        qint64 m_elapsedUs = 0;
+        qint64 m_busyUs = 0; // spent inside the filter
+    };
+
+    explicit MqttsnClientFilterReplay(MqttsnClientFilter& filter, QObject* parentObj = nullptr);
+    ~MqttsnClientFilterReplay() noexcept;
+
+    bool start(const QString& path, double speed);
+
+    const Report& report() const
+    {
+        return m_report;
+    }
+
+signals:
+    void sigFinished();
+
+private slots:
+    void step();
+
+private:
+    using Record = MqttsnClientFilterCapture::Record;
+    using RecordsList = std::vector<Record>;
+
+    bool readInputInternal();
+    void feedInternal(const Record& record);
+    void outputInternal(const cc_tools_qt::DataInfo& info);
+    qint64 elapsedUs() const;
+
+    MqttsnClientFilter& m_filter;
+    MqttsnClientFilterCapture m_capture;
+    RecordsList m_expected;
+    std::size_t m_expectedIdx = 0U;
+    Record m_next;
+    bool m_hasNext = false;
+    double m_speed = 1.0;
+    QTimer m_timer;
+    std::chrono::steady_clock::time_point m_startTs;
+    Report m_report;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,63 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterRttEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const double Alpha = 1.0 / 8;
+const double Beta = 1.0 / 4;
+const double VarianceFactor = 4.0;
+const double ClockGranularityMs = 10.0;
+
+} // namespace
+
+void MqttsnClientFilterRttEstimator::reset()
+{
+    *this = MqttsnClientFilterRttEstimator();
+}
+
+void MqttsnClientFilterRttEstimator::addSample(double rttMs)
+{
+    m_lastSample = rttMs;
+    if (m_samples == 0U) {
+        m_srtt = rttMs;
+        m_rttVar = rttMs / 2;
+    }
+    else {
+        m_rttVar = ((1.0 - Beta) * m_rttVar) + (Beta * std::abs(m_srtt - rttMs));
+        m_srtt = ((1.0 - Alpha) * m_srtt) + (Alpha * rttMs);
+    }
+
+    ++m_samples;
+}
+
+unsigned MqttsnClientFilterRttEstimator::retryPeriod(unsigned minMs, unsigned maxMs) const
+{
+    auto rto = m_srtt + std::max(ClockGranularityMs, VarianceFactor * m_rttVar);
+    auto result = static_cast<unsigned>(std::ceil(rto));
+    return std::min(std::max(result, minMs), std::max(minMs, maxMs));
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
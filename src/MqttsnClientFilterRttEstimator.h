@@ -0,0 +1,67 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Smoothed round trip time estimation as described in RFC 6298
+class MqttsnClientFilterRttEstimator
+{
+public:
+    void reset();
+    void addSample(double rttMs);
+
+    bool hasEstimate() const
+    {
+        return 0U < m_samples;
+    }
+
+    double srtt() const
+    {
+        return m_srtt;
+    }
+
+    double rttVar() const
+    {
+        return m_rttVar;
+    }
+
+    double lastSample() const
+    {
+        return m_lastSample;
+    }
+
+    unsigned samples() const
+    {
+        return m_samples;
+    }
+
+    unsigned retryPeriod(unsigned minMs, unsigned maxMs) const;
+
+private:
+    double m_srtt = 0.0;
+    double m_rttVar = 0.0;
+    double m_lastSample = 0.0;
+    unsigned m_samples = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
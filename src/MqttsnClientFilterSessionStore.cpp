@@ -0,0 +1,286 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSessionStore.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSaveFile>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const char Magic[] = {'C', 'C', 'S', 'N', 1};
+const std::size_t MagicLen = std::extent<decltype(Magic)>::value;
+const std::size_t RecordHeaderLen = 3U;
+
+enum RecordType : unsigned
+{
+    RecordType_ClientId = 1,
+    RecordType_Subscribe = 2,
+};
+
+unsigned readU16(const char* data)
+{
+    return
+        (static_cast<unsigned>(static_cast<std::uint8_t>(data[0])) << 8U) |
+        static_cast<unsigned>(static_cast<std::uint8_t>(data[1]));
+}
+
+void writeU16(unsigned value, char* data)
+{
+    data[0] = static_cast<char>((value >> 8U) & 0xff);
+    data[1] = static_cast<char>(value & 0xff);
+}
+
+bool makeRecord(unsigned type, const char* data, unsigned dataLen, QByteArray& record)
+{
+    if (std::numeric_limits<std::uint16_t>::max() < dataLen) {
+        return false;
+    }
+
+    char header[RecordHeaderLen] = {0};
+    header[0] = static_cast<char>(type);
+    writeU16(dataLen, &header[1]);
+
+    record.append(header, static_cast<int>(RecordHeaderLen));
+    record.append(data, static_cast<int>(dataLen));
+    return true;
+}
+
+QByteArray makeSubscribePayload(const std::string& topic, unsigned topicId, int qos)
+{
+    QByteArray payload(3, '\0');
+    writeU16(topicId, payload.data());
+    payload[2] = static_cast<char>(qos);
+    payload.append(topic.data(), static_cast<int>(topic.size()));
+    return payload;
+}
+
+} // namespace
+
+MqttsnClientFilterSessionStore::MqttsnClientFilterSessionStore() = default;
+MqttsnClientFilterSessionStore::~MqttsnClientFilterSessionStore() noexcept = default;
+
+bool MqttsnClientFilterSessionStore::load(const QString& path)
+{
+    close();
+    m_clientId.clear();
+    m_subscribes.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    auto contents = m_file.readAll();
+    m_file.close();
+
+    if ((static_cast<std::size_t>(contents.size()) < MagicLen) ||
+        (!std::equal(std::begin(Magic), std::end(Magic), contents.constData()))) {
+        return false;
+    }
+
+    auto* pos = contents.constData() + MagicLen;
+    auto* end = contents.constData() + contents.size();
+    bool hasClientId = false;
+    bool replaced = false;
+    while (static_cast<std::size_t>(std::distance(pos, end)) >= RecordHeaderLen) {
+        auto type = static_cast<unsigned>(static_cast<std::uint8_t>(pos[0]));
+        auto len = readU16(pos + 1);
+        auto* payload = pos + RecordHeaderLen;
+        if (static_cast<unsigned>(std::distance(payload, end)) < len) {
+            // Partially written record, the remaining data is unusable
+            break;
+        }
+
+        pos = payload + len;
+
+        if (type == RecordType_ClientId) {
+            m_clientId.assign(payload, len);
+            hasClientId = true;
+            continue;
+        }
+
+        if ((type != RecordType_Subscribe) || (len < 3U)) {
+            continue;
+        }
+
+        SubInfo info;
+        info.m_topicId = readU16(payload);
+        info.m_qos = static_cast<int>(static_cast<std::uint8_t>(payload[2]));
+        info.m_topic.assign(payload + 3, len - 3U);
+
+        // The later record of the same topic replaces the earlier one
+        auto iter = findSubscribe(info.m_topic, info.m_topicId);
+        if (iter != m_subscribes.end()) {
+            *iter = std::move(info);
+            replaced = true;
+            continue;
+        }
+
+        m_subscribes.push_back(std::move(info));
+    }
+
+    if ((!hasClientId) || (m_clientId.empty())) {
+        m_subscribes.clear();
+        return false;
+    }
+
+    if (replaced) {
+        // Rewritten without the replaced records to keep the file size bounded
+        return compact(path);
+    }
+
+    // The new records must not follow the partially written one, 
+    // otherwise they are never loaded.
+    auto goodLen = static_cast<qint64>(std::distance(contents.constData(), pos));
+    if ((goodLen < contents.size()) && (!m_file.resize(goodLen))) {
+        return compact(path);
+    }
+
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+bool MqttsnClientFilterSessionStore::reset(const QString& path, const std::string& clientId)
+{
+    close();
+    m_clientId = clientId;
+    m_subscribes.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    if (m_file.write(Magic, static_cast<qint64>(MagicLen)) != static_cast<qint64>(MagicLen)) {
+        close();
+        return false;
+    }
+
+    return appendRecord(RecordType_ClientId, clientId.data(), static_cast<unsigned>(clientId.size()));
+}
+
+bool MqttsnClientFilterSessionStore::compact(const QString& path)
+{
+    QByteArray contents(reinterpret_cast<const char*>(Magic), static_cast<int>(MagicLen));
+    if (!makeRecord(RecordType_ClientId, m_clientId.data(), static_cast<unsigned>(m_clientId.size()), contents)) {
+        return false;
+    }
+
+    for (auto& info : m_subscribes) {
+        auto payload = makeSubscribePayload(info.m_topic, info.m_topicId, info.m_qos);
+        if (!makeRecord(RecordType_Subscribe, payload.constData(), static_cast<unsigned>(payload.size()), contents)) {
+            return false;
+        }
+    }
+
+    // Replaced atomically, the crash leaves either the old or the new file
+    QSaveFile saveFile(path);
+    if ((!saveFile.open(QIODevice::WriteOnly)) || 
+        (saveFile.write(contents) != static_cast<qint64>(contents.size())) ||
+        (!saveFile.commit())) {
+        return false;
+    }
+
+    m_file.setFileName(path);
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+void MqttsnClientFilterSessionStore::addSubscribe(const std::string& topic, unsigned topicId, int qos)
+{
+    if ((!m_file.isOpen()) || (hasSubscribe(topic, topicId, qos))) {
+        return;
+    }
+
+    auto payload = makeSubscribePayload(topic, topicId, qos);
+    if (!appendRecord(RecordType_Subscribe, payload.constData(), static_cast<unsigned>(payload.size()))) {
+        return;
+    }
+
+    // Resubscription with the different QoS replaces the stored one
+    auto iter = findSubscribe(topic, topicId);
+    if (iter != m_subscribes.end()) {
+        iter->m_qos = qos;
+        return;
+    }
+
+    SubInfo info;
+    info.m_topic = topic;
+    info.m_topicId = topicId;
+    info.m_qos = qos;
+    m_subscribes.push_back(std::move(info));
+}
+
+void MqttsnClientFilterSessionStore::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool MqttsnClientFilterSessionStore::hasSubscribe(const std::string& topic, unsigned topicId, int qos) const
+{
+    return
+        std::any_of(
+            m_subscribes.begin(), m_subscribes.end(),
+            [&topic, topicId, qos](auto& info)
+            {
+                return (info.m_topic == topic) && (info.m_topicId == topicId) && (info.m_qos == qos);
+            });
+}
+
+MqttsnClientFilterSessionStore::SubInfosList::iterator MqttsnClientFilterSessionStore::findSubscribe(const std::string& topic, unsigned topicId)
+{
+    return
+        std::find_if(
+            m_subscribes.begin(), m_subscribes.end(),
+            [&topic, topicId](auto& info)
+            {
+                return (info.m_topic == topic) && (info.m_topicId == topicId);
+            });
+}
+
+bool MqttsnClientFilterSessionStore::appendRecord(unsigned type, const char* data, unsigned dataLen)
+{
+    assert(m_file.isOpen());
+
+    // Single write of the whole record reduces the chance of partial record on crash
+    QByteArray record;
+    if (!makeRecord(type, data, dataLen, record)) {
+        return false;
+    }
+
+    if (m_file.write(record) != static_cast<qint64>(record.size())) {
+        close();
+        return false;
+    }
+
+    m_file.flush();
+    return true;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
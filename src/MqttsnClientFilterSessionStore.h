@@ -0,0 +1,83 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <string>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Keeps the state of the established session in a compact append-only file.
+// The file starts with a header record holding the client ID followed by
+// the record of every subscription confirmed by the gateway. The later record
+// of the same topic replaces the earlier one, the file is compacted on load.
+class MqttsnClientFilterSessionStore
+{
+public:
+    struct SubInfo
+    {
+        std::string m_topic;
+        unsigned m_topicId = 0U;
+        int m_qos = 0;
+    };
+
+    using SubInfosList = std::vector<SubInfo>;
+
+    MqttsnClientFilterSessionStore();
+    ~MqttsnClientFilterSessionStore() noexcept;
+
+    bool load(const QString& path);
+    bool reset(const QString& path, const std::string& clientId);
+    void addSubscribe(const std::string& topic, unsigned topicId, int qos);
+    void close();
+
+    bool isOpen() const
+    {
+        return m_file.isOpen();
+    }
+
+    const std::string& clientId() const
+    {
+        return m_clientId;
+    }
+
+    const SubInfosList& subscribes() const
+    {
+        return m_subscribes;
+    }
+
+    bool hasSubscribe(const std::string& topic, unsigned topicId, int qos) const;
+
+private:
+    bool compact(const QString& path);
+    SubInfosList::iterator findSubscribe(const std::string& topic, unsigned topicId);
+    bool appendRecord(unsigned type, const char* data, unsigned dataLen);
+
+    QFile m_file;
+    std::string m_clientId;
+    SubInfosList m_subscribes;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
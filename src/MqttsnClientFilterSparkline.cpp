@@ -0,0 +1,94 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSparkline.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QPolygonF>
+
+#include <algorithm>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::size_t MaxValues = 120U;
+const int SparklineWidth = 240;
+const int SparklineHeight = 32;
+
+} // namespace
+
+MqttsnClientFilterSparkline::MqttsnClientFilterSparkline(QWidget* parentObj) :
+    Base(parentObj)
+{
+    setMinimumSize(SparklineWidth / 2, SparklineHeight);
+}
+
+MqttsnClientFilterSparkline::~MqttsnClientFilterSparkline() noexcept = default;
+
+void MqttsnClientFilterSparkline::addValue(double value)
+{
+    m_values.push_back(value);
+    while (MaxValues < m_values.size()) {
+        m_values.pop_front();
+    }
+
+    update();
+}
+
+void MqttsnClientFilterSparkline::clear()
+{
+    m_values.clear();
+    update();
+}
+
+QSize MqttsnClientFilterSparkline::sizeHint() const
+{
+    return QSize(SparklineWidth, SparklineHeight);
+}
+
+void MqttsnClientFilterSparkline::paintEvent([[maybe_unused]] QPaintEvent* event)
+{
+    if (m_values.size() < 2U) {
+        return;
+    }
+
+    auto minMax = std::minmax_element(m_values.begin(), m_values.end());
+    auto minValue = *minMax.first;
+    auto range = std::max(*minMax.second - minValue, 1.0);
+
+    auto area = rect().adjusted(1, 1, -1, -1);
+    auto step = static_cast<double>(area.width()) / static_cast<double>(MaxValues - 1U);
+    auto startX = area.left() + (static_cast<double>(MaxValues - m_values.size()) * step);
+
+    QPolygonF points;
+    points.reserve(static_cast<int>(m_values.size()));
+    for (auto idx = 0U; idx < m_values.size(); ++idx) {
+        auto x = startX + (static_cast<double>(idx) * step);
+        auto y = area.top() + (area.height() * (1.0 - ((m_values[idx] - minValue) / range)));
+        points.append(QPointF(x, y));
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().color(QPalette::Highlight), 1.5));
+    painter.drawPolyline(points);
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -18,39 +18,33 @@
 
 #pragma once
 
-#include "ui_MqttsnClientFilterSubConfigWidget.h"
-
-#include "MqttsnClientFilter.h"
-
 #include <QtWidgets/QWidget>
 
+#include <deque>
 
 namespace cc_plugin_mqttsn_client_filter
 {
 
-class MqttsnClientFilterSubConfigWidget : public QWidget
+// Small line chart of the recent values scaled to the widget height
+class MqttsnClientFilterSparkline : public QWidget
 {
     Q_OBJECT
     using Base = QWidget;
 
 public:
-    using SubConfig = MqttsnClientFilter::SubConfig;
+    explicit MqttsnClientFilterSparkline(QWidget* parentObj = nullptr);
+    ~MqttsnClientFilterSparkline() noexcept;
 
-    explicit MqttsnClientFilterSubConfigWidget(MqttsnClientFilter& filter, SubConfig& config, QWidget* parentObj = nullptr);
-    ~MqttsnClientFilterSubConfigWidget() noexcept = default;
+    void addValue(double value);
+    void clear();
 
-private slots:
-    void topicUpdated(const QString& val);
-    void topicIdUpdated(int val);
-    void maxQosUpdated(int val);
-    void delClicked(bool checked);
+    virtual QSize sizeHint() const override;
 
-private:
-    void refresh();
+protected:
+    virtual void paintEvent(QPaintEvent* event) override;
 
-    MqttsnClientFilter& m_filter;
-    SubConfig& m_config;
-    Ui::MqttsnClientFilterSubConfigWidget m_ui;
+private:
+    std::deque<double> m_values;
 };
 
 }  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,325 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSpillLog.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const qint64 MaxSegmentSize = 4 * 1024 * 1024;
+const qint64 RecordHeaderLen = 8;
+const QString SegmentSuffix(".seg");
+const QString SegmentFilter("*.seg");
+
+std::uint32_t readU32(const uchar* data)
+{
+    return
+        (static_cast<std::uint32_t>(data[0]) << 24U) |
+        (static_cast<std::uint32_t>(data[1]) << 16U) |
+        (static_cast<std::uint32_t>(data[2]) << 8U) |
+        static_cast<std::uint32_t>(data[3]);
+}
+
+void writeU32(std::uint32_t value, char* data)
+{
+    data[0] = static_cast<char>((value >> 24U) & 0xff);
+    data[1] = static_cast<char>((value >> 16U) & 0xff);
+    data[2] = static_cast<char>((value >> 8U) & 0xff);
+    data[3] = static_cast<char>(value & 0xff);
+}
+
+} // namespace
+
+MqttsnClientFilterSpillLog::MqttsnClientFilterSpillLog() = default;
+
+MqttsnClientFilterSpillLog::~MqttsnClientFilterSpillLog() noexcept
+{
+    close();
+}
+
+bool MqttsnClientFilterSpillLog::open(const QString& dir)
+{
+    close();
+
+    QDir spillDir(dir);
+    if ((!spillDir.exists()) && (!spillDir.mkpath("."))) {
+        return false;
+    }
+
+    m_dir = dir;
+    m_nextId = 0U;
+
+    // Segments left from the previous run still contain undelivered messages
+    auto existing = spillDir.entryList(QStringList(SegmentFilter), QDir::Files, QDir::Name);
+    for (auto& name : existing) {
+        bool ok = false;
+        auto segId = name.left(name.size() - SegmentSuffix.size()).toUInt(&ok);
+        if (!ok) {
+            continue;
+        }
+
+        m_nextId = std::max(m_nextId, segId + 1U);
+        auto filePtr = std::make_unique<QFile>(segmentPath(segId));
+        auto size = filePtr->size();
+        if (size <= 0) {
+            filePtr->remove();
+            continue;
+        }
+
+        m_segments.resize(m_segments.size() + 1U);
+        auto& seg = m_segments.back();
+        seg.m_id = segId;
+        seg.m_file = std::move(filePtr);
+        seg.m_size = size;
+    }
+
+    return true;
+}
+
+void MqttsnClientFilterSpillLog::close()
+{
+    for (auto& seg : m_segments) {
+        assert(seg.m_file);
+        if ((seg.m_map != nullptr) && (seg.m_file)) {
+            seg.m_file->unmap(const_cast<uchar*>(seg.m_map));
+        }
+    }
+
+    m_segments.clear();
+    m_dir.clear();
+}
+
+bool MqttsnClientFilterSpillLog::isEmpty() const
+{
+    return
+        std::all_of(
+            m_segments.begin(), m_segments.end(),
+            [this](auto& seg)
+            {
+                return isExhausted(seg);
+            });
+}
+
+bool MqttsnClientFilterSpillLog::append(const cc_tools_qt::DataInfo& info)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    Segment* seg = nullptr;
+    if ((!m_segments.empty()) && (m_segments.back().m_writable) && (m_segments.back().m_size < MaxSegmentSize)) {
+        seg = &m_segments.back();
+    }
+    else {
+        if ((!m_segments.empty()) && (m_segments.back().m_writable)) {
+            sealSegment(m_segments.back());
+        }
+
+        seg = createSegment();
+    }
+
+    if (seg == nullptr) {
+        return false;
+    }
+
+    QByteArray props;
+    {
+        QDataStream stream(&props, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream << info.m_extraProperties;
+    }
+
+    auto recLen = RecordHeaderLen + props.size() + static_cast<qint64>(info.m_data.size());
+    QByteArray record(static_cast<int>(RecordHeaderLen), '\0');
+    record.reserve(static_cast<int>(recLen));
+    writeU32(static_cast<std::uint32_t>(recLen), record.data());
+    writeU32(static_cast<std::uint32_t>(props.size()), record.data() + 4);
+    record.append(props);
+    record.append(reinterpret_cast<const char*>(info.m_data.data()), static_cast<int>(info.m_data.size()));
+
+    // Written unbuffered for the record to survive the process crash,
+    // the partially written record is truncated not to corrupt the next ones.
+    if ((seg->m_file->write(record) != recLen) || (!seg->m_file->flush())) {
+        seg->m_file->resize(seg->m_size);
+        return false;
+    }
+
+    seg->m_size += recLen;
+    return true;
+}
+
+cc_tools_qt::DataInfoPtr MqttsnClientFilterSpillLog::readNext(SegmentId& segId)
+{
+    for (auto iter = m_segments.begin(); iter != m_segments.end(); ) {
+        auto& seg = *iter;
+        if (isExhausted(seg)) {
+            ++iter;
+            continue;
+        }
+
+        if ((seg.m_writable) && (!sealSegment(seg))) {
+            removeSegment(iter++);
+            continue;
+        }
+
+        if (seg.m_map == nullptr) {
+            if ((!seg.m_file->isOpen()) && (!seg.m_file->open(QIODevice::ReadOnly))) {
+                removeSegment(iter++);
+                continue;
+            }
+
+            seg.m_size = seg.m_file->size();
+            seg.m_map = seg.m_file->map(0, seg.m_size);
+            if (seg.m_map == nullptr) {
+                removeSegment(iter++);
+                continue;
+            }
+        }
+
+        auto remLen = seg.m_size - seg.m_readPos;
+        auto* rec = seg.m_map + seg.m_readPos;
+        qint64 recLen = 0;
+        qint64 propsLen = 0;
+        if (RecordHeaderLen <= remLen) {
+            recLen = static_cast<qint64>(readU32(rec));
+            propsLen = static_cast<qint64>(readU32(rec + 4));
+        }
+
+        if ((remLen < RecordHeaderLen) || (recLen < RecordHeaderLen) || (remLen < recLen) || ((recLen - RecordHeaderLen) < propsLen)) {
+            // Truncated or corrupted tail, skip the rest of the segment
+            seg.m_readPos = seg.m_size;
+            if (seg.m_outstanding == 0U) {
+                removeSegment(iter++);
+                continue;
+            }
+
+            ++iter;
+            continue;
+        }
+
+        auto dataInfo = cc_tools_qt::makeDataInfoTimed();
+        {
+            auto props = QByteArray::fromRawData(reinterpret_cast<const char*>(rec + RecordHeaderLen), static_cast<int>(propsLen));
+            QDataStream stream(props);
+            stream.setVersion(QDataStream::Qt_5_15);
+            stream >> dataInfo->m_extraProperties;
+        }
+
+        auto* payload = rec + RecordHeaderLen + propsLen;
+        dataInfo->m_data.assign(payload, rec + recLen);
+
+        seg.m_readPos += recLen;
+        ++seg.m_outstanding;
+        segId = seg.m_id;
+
+        if (isExhausted(seg)) {
+            seg.m_file->unmap(const_cast<uchar*>(seg.m_map));
+            seg.m_map = nullptr;
+            seg.m_file->close();
+        }
+
+        return dataInfo;
+    }
+
+    return cc_tools_qt::DataInfoPtr();
+}
+
+void MqttsnClientFilterSpillLog::release(SegmentId segId)
+{
+    auto iter =
+        std::find_if(
+            m_segments.begin(), m_segments.end(),
+            [segId](auto& seg)
+            {
+                return seg.m_id == segId;
+            });
+
+    if (iter == m_segments.end()) {
+        return;
+    }
+
+    assert(0U < iter->m_outstanding);
+    if (0U < iter->m_outstanding) {
+        --iter->m_outstanding;
+    }
+
+    if ((iter->m_outstanding == 0U) && (isExhausted(*iter))) {
+        removeSegment(iter);
+    }
+}
+
+QString MqttsnClientFilterSpillLog::segmentPath(SegmentId segId) const
+{
+    return QDir(m_dir).filePath(QString("%1").arg(segId, 10, 10, QChar('0')) + SegmentSuffix);
+}
+
+MqttsnClientFilterSpillLog::Segment* MqttsnClientFilterSpillLog::createSegment()
+{
+    auto segId = m_nextId;
+    auto filePtr = std::make_unique<QFile>(segmentPath(segId));
+    if (!filePtr->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        return nullptr;
+    }
+
+    ++m_nextId;
+    m_segments.resize(m_segments.size() + 1U);
+    auto& seg = m_segments.back();
+    seg.m_id = segId;
+    seg.m_file = std::move(filePtr);
+    seg.m_writable = true;
+    return &seg;
+}
+
+bool MqttsnClientFilterSpillLog::sealSegment(Segment& seg)
+{
+    assert(seg.m_writable);
+    seg.m_writable = false;
+    seg.m_file->close();
+    return seg.m_file->error() == QFileDevice::NoError;
+}
+
+bool MqttsnClientFilterSpillLog::isExhausted(const Segment& seg) const
+{
+    return (!seg.m_writable) && (seg.m_size <= seg.m_readPos);
+}
+
+void MqttsnClientFilterSpillLog::removeSegment(SegmentsList::iterator iter)
+{
+    auto& seg = *iter;
+    if (seg.m_map != nullptr) {
+        seg.m_file->unmap(const_cast<uchar*>(seg.m_map));
+    }
+
+    seg.m_file->close();
+    seg.m_file->remove();
+    m_segments.erase(iter);
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,89 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cc_tools_qt/DataInfo.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <list>
+#include <memory>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Append-only log of pending messages split into segment files.
+// The records are written to the last segment and read from the
+// sealed ones using memory mapping. The segment file is removed
+// when all its records have been read and released.
+class MqttsnClientFilterSpillLog
+{
+public:
+    using SegmentId = unsigned;
+
+    MqttsnClientFilterSpillLog();
+    ~MqttsnClientFilterSpillLog() noexcept;
+
+    bool open(const QString& dir);
+    void close();
+
+    bool isOpen() const
+    {
+        return !m_dir.isEmpty();
+    }
+
+    const QString& dir() const
+    {
+        return m_dir;
+    }
+
+    bool isEmpty() const;
+    bool append(const cc_tools_qt::DataInfo& info);
+    cc_tools_qt::DataInfoPtr readNext(SegmentId& segId);
+    void release(SegmentId segId);
+
+private:
+    struct Segment
+    {
+        SegmentId m_id = 0U;
+        std::unique_ptr<QFile> m_file;
+        const uchar* m_map = nullptr;
+        qint64 m_size = 0;
+        qint64 m_readPos = 0;
+        unsigned m_outstanding = 0U;
+        bool m_writable = false;
+    };
+
+    using SegmentsList = std::list<Segment>;
+
+    QString segmentPath(SegmentId segId) const;
+    Segment* createSegment();
+    bool sealSegment(Segment& seg);
+    bool isExhausted(const Segment& seg) const;
+    void removeSegment(SegmentsList::iterator iter);
+
+    QString m_dir;
+    SegmentsList m_segments;
+    SegmentId m_nextId = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
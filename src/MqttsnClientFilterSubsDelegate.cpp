@@ -0,0 +1,54 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSubsDelegate.h"
+
+#include "MqttsnClientFilterSubsModel.h"
+
+#include <QtWidgets/QSpinBox>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+MqttsnClientFilterSubsDelegate::MqttsnClientFilterSubsDelegate(QObject* parentObj) :
+    Base(parentObj)
+{
+}
+
+MqttsnClientFilterSubsDelegate::~MqttsnClientFilterSubsDelegate() noexcept = default;
+
+QWidget* MqttsnClientFilterSubsDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    int maxValue = 0;
+    if (index.column() == MqttsnClientFilterSubsModel::Column_TopicId) {
+        maxValue = 0xffff;
+    }
+    else if (index.column() == MqttsnClientFilterSubsModel::Column_MaxQos) {
+        maxValue = 2;
+    }
+    else {
+        return Base::createEditor(parent, option, index);
+    }
+
+    // The value is transferred by the base class using the editor's user property
+    auto* editor = new QSpinBox(parent);
+    editor->setFrame(false);
+    editor->setRange(0, maxValue);
+    return editor;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,41 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtWidgets/QStyledItemDelegate>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Provides the subscription table editors limited to the valid ranges
+class MqttsnClientFilterSubsDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+    using Base = QStyledItemDelegate;
+
+public:
+    explicit MqttsnClientFilterSubsDelegate(QObject* parentObj = nullptr);
+    ~MqttsnClientFilterSubsDelegate() noexcept;
+
+    virtual QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,447 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSubsIo.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QJsonValue>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+#include <algorithm>
+#include <cstring>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const int MaxLineLen = 1024;
+const int MaxTopicId = 0xffff;
+const int MaxQos = 2;
+const char CsvHeader[] = "topic,topic_id,qos\n";
+
+const QString& topicKey()
+{
+    static const QString Str("topic");
+    return Str;
+}
+
+const QString& topicIdKey()
+{
+    static const QString Str("topic_id");
+    return Str;
+}
+
+const QString& qosKey()
+{
+    static const QString Str("qos");
+    return Str;
+}
+
+bool isJsonFile(const QString& path)
+{
+    return QFileInfo(path).suffix().compare("json", Qt::CaseInsensitive) == 0;
+}
+
+bool isValidTopicFilter(const QString& topic)
+{
+    auto levels = topic.split('/');
+    for (auto idx = 0; idx < levels.size(); ++idx) {
+        auto& level = levels[idx];
+        if ((level.contains('#')) && ((level != "#") || (idx != (levels.size() - 1)))) {
+            return false;
+        }
+
+        if ((level.contains('+')) && (level != "+")) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString subKey(const QString& topic, int topicId)
+{
+    if (!topic.isEmpty()) {
+        return topic;
+    }
+
+    return QString("#%1").arg(topicId);
+}
+
+bool parseNumber(const char* begin, const char* end, int& value)
+{
+    while ((begin < end) && ((*begin == ' ') || (*begin == '\t'))) {
+        ++begin;
+    }
+
+    while ((begin < end) && ((end[-1] == ' ') || (end[-1] == '\t'))) {
+        --end;
+    }
+
+    if (begin == end) {
+        value = -1;
+        return true;
+    }
+
+    value = 0;
+    for (; begin < end; ++begin) {
+        if ((*begin < '0') || ('9' < *begin) || (MaxTopicId < value)) {
+            return false;
+        }
+
+        value = (value * 10) + (*begin - '0');
+    }
+
+    return true;
+}
+
+class Merger
+{
+public:
+    using SubConfig = MqttsnClientFilter::SubConfig;
+    using SubConfigsList = MqttsnClientFilter::SubConfigsList;
+    using ImportResult = MqttsnClientFilterSubsIo::ImportResult;
+
+    Merger(SubConfigsList& subs, ImportResult& result) :
+        m_subs(subs),
+        m_result(result)
+    {
+        m_existing.reserve(static_cast<int>(subs.size()));
+        for (auto& sub : subs) {
+            m_existing.insert(subKey(sub.m_topic, sub.m_topicId), &sub);
+        }
+    }
+
+    void invalid(qint64 entryNum, const QString& reason)
+    {
+        ++m_result.m_invalid;
+        if (m_result.m_error.isEmpty()) {
+            m_result.m_error = QString("entry %1: ").arg(entryNum) + reason;
+        }
+    }
+
+    void add(qint64 entryNum, const QString& topic, int topicId, int qos)
+    {
+        if (topicId < 0) {
+            topicId = 0;
+        }
+
+        if (qos < 0) {
+            qos = MaxQos;
+        }
+
+        if (topic.isEmpty() && (topicId == 0)) {
+            invalid(entryNum, "neither topic nor topic ID is specified");
+            return;
+        }
+
+        if ((!topic.isEmpty()) && (topicId != 0)) {
+            invalid(entryNum, "both topic and topic ID are specified");
+            return;
+        }
+
+        if ((!topic.isEmpty()) && (!isValidTopicFilter(topic))) {
+            invalid(entryNum, "invalid topic filter " + topic);
+            return;
+        }
+
+        if ((MaxTopicId < topicId) || (MaxQos < qos)) {
+            invalid(entryNum, "value out of range");
+            return;
+        }
+
+        auto key = subKey(topic, topicId);
+        if (m_seen.contains(key)) {
+            ++m_result.m_duplicates;
+            return;
+        }
+
+        m_seen.insert(key);
+
+        auto* sub = m_existing.value(key, nullptr);
+        if (sub != nullptr) {
+            if (sub->m_maxQos == qos) {
+                ++m_result.m_duplicates;
+                return;
+            }
+
+            sub->m_maxQos = qos;
+            ++m_result.m_updated;
+            return;
+        }
+
+        m_subs.resize(m_subs.size() + 1U);
+        auto& newSub = m_subs.back();
+        newSub.m_topic = topic;
+        newSub.m_topicId = topicId;
+        newSub.m_maxQos = qos;
+        ++m_result.m_added;
+    }
+
+private:
+    SubConfigsList& m_subs;
+    ImportResult& m_result;
+    QHash<QString, SubConfig*> m_existing;
+    QSet<QString> m_seen;
+};
+
+bool importCsv(QFile& file, Merger& merger, MqttsnClientFilterSubsIo::ImportResult& result)
+{
+    char line[MaxLineLen + 1] = {0};
+    qint64 lineNum = 0;
+    bool tooLong = false;
+    while (true) {
+        auto len = file.readLine(line, sizeof(line));
+        if (len < 0) {
+            break;
+        }
+
+        // The remainder of the too long line is read as the next chunks
+        bool complete = (0 < len) && (line[len - 1] == '\n');
+        if (tooLong) {
+            tooLong = !complete;
+            continue;
+        }
+
+        ++lineNum;
+        if (!complete && (MaxLineLen <= len)) {
+            tooLong = true;
+            merger.invalid(lineNum, "line is too long");
+            continue;
+        }
+
+        auto* pos = line;
+        auto* end = line + len;
+        while ((pos < end) && ((end[-1] == '\n') || (end[-1] == '\r'))) {
+            --end;
+        }
+
+        if (pos == end) {
+            continue;
+        }
+
+        QString topic;
+        if (*pos == '"') {
+            // Quoted topic, the double quote is escaped by doubling it
+            QByteArray quoted;
+            ++pos;
+            while (pos < end) {
+                if (*pos != '"') {
+                    quoted.append(*pos);
+                    ++pos;
+                    continue;
+                }
+
+                if (((pos + 1) < end) && (pos[1] == '"')) {
+                    quoted.append('"');
+                    pos += 2;
+                    continue;
+                }
+
+                ++pos;
+                break;
+            }
+
+            topic = QString::fromUtf8(quoted);
+        }
+        else {
+            auto* sep = std::find(pos, end, ',');
+            topic = QString::fromUtf8(pos, static_cast<int>(sep - pos)).trimmed();
+            pos = sep;
+        }
+
+        if ((lineNum == 1) && (topic.compare(topicKey(), Qt::CaseInsensitive) == 0)) {
+            continue;
+        }
+
+        int topicId = -1;
+        int qos = -1;
+        if ((pos < end) && (*pos == ',')) {
+            ++pos;
+            auto* sep = std::find(pos, end, ',');
+            bool ok = parseNumber(pos, sep, topicId);
+            if (ok && (sep < end)) {
+                ok = parseNumber(sep + 1, end, qos);
+            }
+
+            if (!ok) {
+                merger.invalid(lineNum, "invalid number");
+                continue;
+            }
+        }
+        else if (pos < end) {
+            merger.invalid(lineNum, "unexpected characters after topic");
+            continue;
+        }
+
+        merger.add(lineNum, topic, topicId, qos);
+    }
+
+    if (file.error() != QFileDevice::NoError) {
+        result.m_error = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool importJson(QFile& file, Merger& merger, MqttsnClientFilterSubsIo::ImportResult& result)
+{
+    // The mapped file contents are parsed without copying into intermediate buffer
+    auto size = file.size();
+    auto* mapped = file.map(0, size);
+    QByteArray contents;
+    if (mapped != nullptr) {
+        contents = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<int>(size));
+    }
+    else {
+        contents = file.readAll();
+    }
+
+    QJsonParseError parseError;
+    auto doc = QJsonDocument::fromJson(contents, &parseError);
+    if (mapped != nullptr) {
+        file.unmap(mapped);
+    }
+
+    if (parseError.error != QJsonParseError::NoError) {
+        result.m_error = parseError.errorString();
+        return false;
+    }
+
+    if (!doc.isArray()) {
+        result.m_error = "array of subscribes is expected";
+        return false;
+    }
+
+    auto arr = doc.array();
+    for (auto idx = 0; idx < arr.size(); ++idx) {
+        auto entryNum = static_cast<qint64>(idx) + 1;
+        auto val = arr.at(idx);
+        if (!val.isObject()) {
+            merger.invalid(entryNum, "object is expected");
+            continue;
+        }
+
+        auto obj = val.toObject();
+        auto topicVal = obj.value(topicKey());
+        auto topicIdVal = obj.value(topicIdKey());
+        auto qosVal = obj.value(qosKey());
+        if (((!topicVal.isUndefined()) && (!topicVal.isString())) ||
+            ((!topicIdVal.isUndefined()) && (!topicIdVal.isDouble())) ||
+            ((!qosVal.isUndefined()) && (!qosVal.isDouble()))) {
+            merger.invalid(entryNum, "invalid value type");
+            continue;
+        }
+
+        merger.add(entryNum, topicVal.toString(), topicIdVal.toInt(-1), qosVal.toInt(-1));
+    }
+
+    return true;
+}
+
+QByteArray csvTopic(const QString& topic)
+{
+    auto utf8 = topic.toUtf8();
+    if ((!utf8.contains(',')) && (!utf8.contains('"')) && (!utf8.startsWith(' ')) && (!utf8.endsWith(' '))) {
+        return utf8;
+    }
+
+    utf8.replace("\"", "\"\"");
+    return '"' + utf8 + '"';
+}
+
+} // namespace
+
+bool MqttsnClientFilterSubsIo::importFile(const QString& path, SubConfigsList& subs, ImportResult& result)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.m_error = file.errorString();
+        return false;
+    }
+
+    Merger merger(subs, result);
+    if (isJsonFile(path)) {
+        return importJson(file, merger, result);
+    }
+
+    return importCsv(file, merger, result);
+}
+
+bool MqttsnClientFilterSubsIo::exportFile(const QString& path, const SubConfigsList& subs, QString& error)
+{
+    QByteArray contents;
+    if (isJsonFile(path)) {
+        QJsonArray arr;
+        for (auto& sub : subs) {
+            QJsonObject obj;
+            if (!sub.m_topic.isEmpty()) {
+                obj.insert(topicKey(), sub.m_topic);
+            }
+            else {
+                obj.insert(topicIdKey(), sub.m_topicId);
+            }
+
+            obj.insert(qosKey(), sub.m_maxQos);
+            arr.append(obj);
+        }
+
+        contents = QJsonDocument(arr).toJson();
+    }
+    else {
+        contents.reserve(static_cast<int>(subs.size() * 32U));
+        contents.append(CsvHeader);
+        for (auto& sub : subs) {
+            if (!sub.m_topic.isEmpty()) {
+                contents.append(csvTopic(sub.m_topic));
+                contents.append(',');
+            }
+            else {
+                contents.append(',');
+                contents.append(QByteArray::number(sub.m_topicId));
+            }
+
+            contents.append(',');
+            contents.append(QByteArray::number(sub.m_maxQos));
+            contents.append('\n');
+        }
+    }
+
+    // The previous file is replaced only when the new one is fully written
+    QSaveFile file(path);
+    if ((!file.open(QIODevice::WriteOnly)) ||
+        (file.write(contents) != static_cast<qint64>(contents.size())) ||
+        (!file.commit())) {
+        error = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,53 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+
+#include <QtCore/QString>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Reads and writes the subscriptions as CSV ("topic,topic_id,qos" lines)
+// or JSON (array of objects with the same keys) files, the format is
+// selected by the file extension. The CSV file is parsed line by line
+// using fixed buffer, the imported entries are validated and merged
+// into the existing list with duplicates detection.
+class MqttsnClientFilterSubsIo
+{
+public:
+    using SubConfigsList = MqttsnClientFilter::SubConfigsList;
+
+    struct ImportResult
+    {
+        unsigned m_added = 0U;
+        unsigned m_updated = 0U;
+        unsigned m_duplicates = 0U;
+        unsigned m_invalid = 0U;
+        QString m_error;
+    };
+
+    static bool importFile(const QString& path, SubConfigsList& subs, ImportResult& result);
+    static bool exportFile(const QString& path, const SubConfigsList& subs, QString& error);
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,279 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterSubsModel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <unordered_set>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const int MaxTopicId = 0xffff;
+const int MaxQos = 2;
+
+} // namespace
+
+MqttsnClientFilterSubsModel::MqttsnClientFilterSubsModel(MqttsnClientFilter& filter, QObject* parentObj) :
+    Base(parentObj),
+    m_filter(filter)
+{
+    sync();
+}
+
+MqttsnClientFilterSubsModel::~MqttsnClientFilterSubsModel() noexcept = default;
+
+void MqttsnClientFilterSubsModel::sync()
+{
+    auto& subs = m_filter.config().m_subscribes;
+    RowsList rows;
+    rows.reserve(subs.size());
+    for (auto& sub : subs) {
+        rows.push_back(&sub);
+    }
+
+    if (rows != m_rows) {
+        // Remove the rows no longer present, contiguous ranges at once
+        std::unordered_set<const SubConfig*> present(rows.begin(), rows.end());
+        for (auto row = static_cast<int>(m_rows.size()) - 1; 0 <= row; --row) {
+            if (present.find(m_rows[static_cast<unsigned>(row)]) != present.end()) {
+                continue;
+            }
+
+            auto last = row;
+            while ((0 < row) && (present.find(m_rows[static_cast<unsigned>(row - 1)]) == present.end())) {
+                --row;
+            }
+
+            beginRemoveRows(QModelIndex(), row, last);
+            m_rows.erase(m_rows.begin() + row, m_rows.begin() + last + 1);
+            endRemoveRows();
+        }
+
+        // Insert the new rows, the order of the remaining ones is expected to be preserved
+        std::size_t newIdx = 0U;
+        std::size_t oldIdx = 0U;
+        while (newIdx < rows.size()) {
+            if ((oldIdx < m_rows.size()) && (m_rows[oldIdx] == rows[newIdx])) {
+                ++oldIdx;
+                ++newIdx;
+                continue;
+            }
+
+            auto first = newIdx;
+            while ((newIdx < rows.size()) && ((m_rows.size() <= oldIdx) || (rows[newIdx] != m_rows[oldIdx]))) {
+                ++newIdx;
+            }
+
+            beginInsertRows(QModelIndex(), static_cast<int>(first), static_cast<int>(newIdx - 1U));
+            m_rows.insert(m_rows.begin() + static_cast<long>(oldIdx), rows.begin() + static_cast<long>(first), rows.begin() + static_cast<long>(newIdx));
+            oldIdx += newIdx - first;
+            endInsertRows();
+        }
+
+        if (rows != m_rows) {
+            // Reordered externally
+            beginResetModel();
+            m_rows = std::move(rows);
+            endResetModel();
+            return;
+        }
+    }
+
+    if (!m_rows.empty()) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, Column_NumOfValues - 1));
+    }
+}
+
+void MqttsnClientFilterSubsModel::addSubscribe()
+{
+    auto& subs = m_filter.config().m_subscribes;
+    auto row = static_cast<int>(m_rows.size());
+    beginInsertRows(QModelIndex(), row, row);
+    subs.resize(subs.size() + 1U);
+    m_rows.push_back(&subs.back());
+    endInsertRows();
+}
+
+int MqttsnClientFilterSubsModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return static_cast<int>(m_rows.size());
+}
+
+int MqttsnClientFilterSubsModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return Column_NumOfValues;
+}
+
+QVariant MqttsnClientFilterSubsModel::data(const QModelIndex& index, int role) const
+{
+    if ((!index.isValid()) || (rowCount() <= index.row()) ||
+        ((role != Qt::DisplayRole) && (role != Qt::EditRole))) {
+        return QVariant();
+    }
+
+    auto& sub = *m_rows[static_cast<unsigned>(index.row())];
+    switch (index.column()) {
+        case Column_Topic: return sub.m_topic;
+        case Column_TopicId: return sub.m_topicId;
+        case Column_MaxQos: return sub.m_maxQos;
+        default: break;
+    }
+
+    return QVariant();
+}
+
+QVariant MqttsnClientFilterSubsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return Base::headerData(section, orientation, role);
+    }
+
+    static const QString Names[] = {
+        tr("Topic Filter"),
+        tr("Topic ID"),
+        tr("Max QoS"),
+    };
+
+    static const std::size_t NamesCount = std::extent<decltype(Names)>::value;
+    static_assert(NamesCount == Column_NumOfValues, "Invalid map");
+
+    if ((section < 0) || (Column_NumOfValues <= section)) {
+        return QVariant();
+    }
+
+    return Names[section];
+}
+
+Qt::ItemFlags MqttsnClientFilterSubsModel::flags(const QModelIndex& index) const
+{
+    auto result = Base::flags(index);
+    if ((!index.isValid()) || (rowCount() <= index.row())) {
+        return result;
+    }
+
+    // The topic and topic ID are mutually exclusive
+    auto& sub = *m_rows[static_cast<unsigned>(index.row())];
+    bool editable =
+        ((index.column() != Column_Topic) || (sub.m_topicId == 0)) &&
+        ((index.column() != Column_TopicId) || (sub.m_topic.isEmpty()));
+
+    if (editable) {
+        result |= Qt::ItemIsEditable;
+    }
+
+    return result;
+}
+
+bool MqttsnClientFilterSubsModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if ((!index.isValid()) || (rowCount() <= index.row()) || (role != Qt::EditRole)) {
+        return false;
+    }
+
+    auto& sub = *m_rows[static_cast<unsigned>(index.row())];
+    switch (index.column()) {
+        case Column_Topic:
+        {
+            auto topic = value.toString();
+            if (topic == sub.m_topic) {
+                return true;
+            }
+
+            sub.m_topic = topic;
+            if (!topic.isEmpty()) {
+                sub.m_topicId = 0;
+            }
+            break;
+        }
+
+        case Column_TopicId:
+        {
+            auto topicId = std::min(std::max(value.toInt(), 0), MaxTopicId);
+            if (topicId == sub.m_topicId) {
+                return true;
+            }
+
+            sub.m_topicId = topicId;
+            if (topicId != 0) {
+                sub.m_topic.clear();
+            }
+            break;
+        }
+
+        case Column_MaxQos:
+        {
+            auto qos = std::min(std::max(value.toInt(), 0), MaxQos);
+            if (qos == sub.m_maxQos) {
+                return true;
+            }
+
+            sub.m_maxQos = qos;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    m_filter.subscribesUpdated();
+    m_filter.forceCleanSession();
+    rowChanged(index.row());
+    return true;
+}
+
+bool MqttsnClientFilterSubsModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if ((parent.isValid()) || (row < 0) || (count <= 0) || (rowCount() < (row + count))) {
+        return false;
+    }
+
+    auto& subs = m_filter.config().m_subscribes;
+    auto first = std::next(subs.begin(), row);
+    auto last = std::next(first, count);
+    assert(&(*first) == m_rows[static_cast<unsigned>(row)]);
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    subs.erase(first, last);
+    m_rows.erase(m_rows.begin() + row, m_rows.begin() + row + count);
+    endRemoveRows();
+
+    m_filter.subscribesUpdated();
+    m_filter.forceCleanSession();
+    return true;
+}
+
+void MqttsnClientFilterSubsModel::rowChanged(int row)
+{
+    emit dataChanged(index(row, 0), index(row, Column_NumOfValues - 1));
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,74 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+
+#include <QtCore/QAbstractTableModel>
+
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Table model exposing the configured subscriptions. The rows refer
+// to the elements of the subscriptions list directly, the external
+// changes of the list are applied as row insertions and removals
+// rather than full model reset.
+class MqttsnClientFilterSubsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    using Base = QAbstractTableModel;
+
+public:
+    enum Column
+    {
+        Column_Topic,
+        Column_TopicId,
+        Column_MaxQos,
+        Column_NumOfValues
+    };
+
+    explicit MqttsnClientFilterSubsModel(MqttsnClientFilter& filter, QObject* parentObj = nullptr);
+    ~MqttsnClientFilterSubsModel() noexcept;
+
+    void sync();
+    void addSubscribe();
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+    virtual bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    virtual bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+
+private:
+    using SubConfig = MqttsnClientFilter::SubConfig;
+    using RowsList = std::vector<SubConfig*>;
+
+    void rowChanged(int row);
+
+    MqttsnClientFilter& m_filter;
+    RowsList m_rows;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,221 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterTopicStats.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSaveFile>
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::size_t MinCapacity = 16U;
+const char CsvHeader[] =
+    "topic,tx_msgs,tx_bytes,tx_qos0,tx_qos1,tx_qos2,tx_last_seen,"
+    "rx_msgs,rx_bytes,rx_qos0,rx_qos1,rx_qos2,rx_last_seen\n";
+
+std::uint32_t topicHash(std::string_view topic)
+{
+    // FNV-1a
+    std::uint32_t hash = 0x811c9dc5U;
+    for (auto ch : topic) {
+        hash ^= static_cast<std::uint8_t>(ch);
+        hash *= 0x01000193U;
+    }
+    return hash;
+}
+
+void appendCsvTopic(const std::string& topic, QByteArray& out)
+{
+    bool needsQuotes =
+        (topic.find_first_of(",\"") != std::string::npos) ||
+        ((!topic.empty()) && ((topic.front() == ' ') || (topic.back() == ' ')));
+
+    if (!needsQuotes) {
+        out.append(topic.data(), static_cast<int>(topic.size()));
+        return;
+    }
+
+    out.append('"');
+    for (auto ch : topic) {
+        if (ch == '"') {
+            out.append('"');
+        }
+        out.append(ch);
+    }
+    out.append('"');
+}
+
+void appendCsvCounters(const MqttsnClientFilterTopicStats::Counters& counters, QByteArray& out)
+{
+    out.append(',');
+    out.append(QByteArray::number(counters.m_msgs));
+    out.append(',');
+    out.append(QByteArray::number(counters.m_bytes));
+    for (auto count : counters.m_qos) {
+        out.append(',');
+        out.append(QByteArray::number(count));
+    }
+    out.append(',');
+    out.append(QByteArray::number(counters.m_lastSeenMs));
+}
+
+} // namespace
+
+MqttsnClientFilterTopicStats::MqttsnClientFilterTopicStats() = default;
+MqttsnClientFilterTopicStats::~MqttsnClientFilterTopicStats() noexcept = default;
+
+void MqttsnClientFilterTopicStats::setMaxTopics(std::size_t value)
+{
+    if (value == m_maxTopics) {
+        return;
+    }
+
+    m_maxTopics = value;
+    if (value < m_entries.size()) {
+        clear();
+    }
+}
+
+void MqttsnClientFilterTopicStats::clear()
+{
+    m_entries.clear();
+    m_slots.clear();
+    m_untracked = 0U;
+}
+
+void MqttsnClientFilterTopicStats::addTx(std::string_view topic, std::size_t bytes, int qos, qint64 timestampMs)
+{
+    auto* entry = findOrInsert(topic);
+    if (entry != nullptr) {
+        addInternal(entry->m_tx, bytes, qos, timestampMs);
+    }
+}
+
+void MqttsnClientFilterTopicStats::addRx(std::string_view topic, std::size_t bytes, int qos, qint64 timestampMs)
+{
+    auto* entry = findOrInsert(topic);
+    if (entry != nullptr) {
+        addInternal(entry->m_rx, bytes, qos, timestampMs);
+    }
+}
+
+bool MqttsnClientFilterTopicStats::exportCsv(const QString& path, QString& error) const
+{
+    QByteArray contents;
+    contents.reserve(static_cast<int>(sizeof(CsvHeader) + (m_entries.size() * 96U)));
+    contents.append(CsvHeader);
+    for (auto& entry : m_entries) {
+        appendCsvTopic(entry.m_topic, contents);
+        appendCsvCounters(entry.m_tx, contents);
+        appendCsvCounters(entry.m_rx, contents);
+        contents.append('\n');
+    }
+
+    QSaveFile file(path);
+    if ((!file.open(QIODevice::WriteOnly)) ||
+        (file.write(contents) != static_cast<qint64>(contents.size())) ||
+        (!file.commit())) {
+        error = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+MqttsnClientFilterTopicStats::Entry* MqttsnClientFilterTopicStats::findOrInsert(std::string_view topic)
+{
+    if (!isEnabled()) {
+        return nullptr;
+    }
+
+    auto hash = topicHash(topic);
+    if (!m_slots.empty()) {
+        auto mask = m_slots.size() - 1U;
+        for (auto pos = static_cast<std::size_t>(hash) & mask; ; pos = (pos + 1U) & mask) {
+            auto& slot = m_slots[pos];
+            if (slot.m_idx == 0U) {
+                break;
+            }
+
+            if ((slot.m_hash == hash) && (m_entries[slot.m_idx - 1U].m_topic == topic)) {
+                return &m_entries[slot.m_idx - 1U];
+            }
+        }
+    }
+
+    if (m_maxTopics <= m_entries.size()) {
+        ++m_untracked;
+        return nullptr;
+    }
+
+    // Keep the load factor at or below 1/2
+    if (m_slots.size() < ((m_entries.size() + 1U) * 2U)) {
+        rehash(std::max(MinCapacity, m_slots.size() * 2U));
+    }
+
+    m_entries.emplace_back();
+    m_entries.back().m_topic.assign(topic.data(), topic.size());
+
+    auto mask = m_slots.size() - 1U;
+    auto pos = static_cast<std::size_t>(hash) & mask;
+    while (m_slots[pos].m_idx != 0U) {
+        pos = (pos + 1U) & mask;
+    }
+
+    m_slots[pos].m_hash = hash;
+    m_slots[pos].m_idx = static_cast<std::uint32_t>(m_entries.size());
+    return &m_entries.back();
+}
+
+void MqttsnClientFilterTopicStats::rehash(std::size_t capacity)
+{
+    assert((capacity & (capacity - 1U)) == 0U);
+    SlotsList newSlots(capacity);
+    auto mask = capacity - 1U;
+    for (auto& slot : m_slots) {
+        if (slot.m_idx == 0U) {
+            continue;
+        }
+
+        auto pos = static_cast<std::size_t>(slot.m_hash) & mask;
+        while (newSlots[pos].m_idx != 0U) {
+            pos = (pos + 1U) & mask;
+        }
+
+        newSlots[pos] = slot;
+    }
+
+    m_slots.swap(newSlots);
+}
+
+void MqttsnClientFilterTopicStats::addInternal(Counters& counters, std::size_t bytes, int qos, qint64 timestampMs)
+{
+    ++counters.m_msgs;
+    counters.m_bytes += bytes;
+    auto qosIdx = static_cast<std::size_t>(std::min(std::max(qos, 0), 2));
+    ++counters.m_qos[qosIdx];
+    counters.m_lastSeenMs = timestampMs;
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
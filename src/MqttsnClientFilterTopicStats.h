@@ -0,0 +1,104 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Per topic traffic counters kept in a flat open addressing hash table.
+// The topic strings are interned in the entries list and the table slots
+// refer to them by index, so recording a message costs a single lookup.
+// The topics seen after the limit is reached are counted as untracked.
+class MqttsnClientFilterTopicStats
+{
+public:
+    struct Counters
+    {
+        unsigned long long m_msgs = 0U;
+        unsigned long long m_bytes = 0U;
+        unsigned long long m_qos[3] = {0U, 0U, 0U};
+        qint64 m_lastSeenMs = 0;
+    };
+
+    struct Entry
+    {
+        std::string m_topic;
+        Counters m_tx;
+        Counters m_rx;
+    };
+
+    using EntriesList = std::vector<Entry>;
+
+    MqttsnClientFilterTopicStats();
+    ~MqttsnClientFilterTopicStats() noexcept;
+
+    void setMaxTopics(std::size_t value);
+    void clear();
+
+    bool isEnabled() const
+    {
+        return 0U < m_maxTopics;
+    }
+
+    void addTx(std::string_view topic, std::size_t bytes, int qos, qint64 timestampMs);
+    void addRx(std::string_view topic, std::size_t bytes, int qos, qint64 timestampMs);
+
+    // In the order of the first appearance
+    const EntriesList& entries() const
+    {
+        return m_entries;
+    }
+
+    unsigned long long untracked() const
+    {
+        return m_untracked;
+    }
+
+    bool exportCsv(const QString& path, QString& error) const;
+
+private:
+    struct Slot
+    {
+        std::uint32_t m_hash = 0U;
+        std::uint32_t m_idx = 0U; // index of the entry + 1, 0 means empty
+    };
+
+    using SlotsList = std::vector<Slot>;
+
+    Entry* findOrInsert(std::string_view topic);
+    void rehash(std::size_t capacity);
+    void addInternal(Counters& counters, std::size_t bytes, int qos, qint64 timestampMs);
+
+    std::size_t m_maxTopics = 0U;
+    EntriesList m_entries;
+    SlotsList m_slots;
+    unsigned long long m_untracked = 0U;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,155 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterTopicStatsModel.h"
+
+#include <QtCore/QDateTime>
+
+#include <type_traits>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+MqttsnClientFilterTopicStatsModel::MqttsnClientFilterTopicStatsModel(MqttsnClientFilter& filter, QObject* parentObj) :
+    Base(parentObj),
+    m_filter(filter)
+{
+    sync();
+}
+
+MqttsnClientFilterTopicStatsModel::~MqttsnClientFilterTopicStatsModel() noexcept = default;
+
+void MqttsnClientFilterTopicStatsModel::sync()
+{
+    auto rows = static_cast<int>(m_filter.topicStats().entries().size());
+    if (rows < m_rows) {
+        // Cleared
+        beginResetModel();
+        m_rows = rows;
+        endResetModel();
+        return;
+    }
+
+    if (m_rows < rows) {
+        beginInsertRows(QModelIndex(), m_rows, rows - 1);
+        m_rows = rows;
+        endInsertRows();
+    }
+
+    if (0 < m_rows) {
+        emit dataChanged(index(0, Column_TxMsgs), index(m_rows - 1, Column_NumOfValues - 1));
+    }
+}
+
+int MqttsnClientFilterTopicStatsModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return m_rows;
+}
+
+int MqttsnClientFilterTopicStatsModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return Column_NumOfValues;
+}
+
+QVariant MqttsnClientFilterTopicStatsModel::data(const QModelIndex& index, int role) const
+{
+    if ((!index.isValid()) || (rowCount() <= index.row()) ||
+        ((role != Qt::DisplayRole) && (role != SortRole))) {
+        return QVariant();
+    }
+
+    auto& entry = m_filter.topicStats().entries()[static_cast<unsigned>(index.row())];
+    auto column = index.column();
+    if (column == Column_Topic) {
+        return QString::fromStdString(entry.m_topic);
+    }
+
+    if (column < Column_RxMsgs) {
+        return countersData(entry.m_tx, column - Column_TxMsgs, role);
+    }
+
+    return countersData(entry.m_rx, column - Column_RxMsgs, role);
+}
+
+QVariant MqttsnClientFilterTopicStatsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return Base::headerData(section, orientation, role);
+    }
+
+    static const QString Names[] = {
+        tr("Topic"),
+        tr("Tx Msgs"),
+        tr("Tx Bytes"),
+        tr("Tx QoS 0/1/2"),
+        tr("Tx Last Seen"),
+        tr("Rx Msgs"),
+        tr("Rx Bytes"),
+        tr("Rx QoS 0/1/2"),
+        tr("Rx Last Seen"),
+    };
+
+    static const std::size_t NamesCount = std::extent<decltype(Names)>::value;
+    static_assert(NamesCount == Column_NumOfValues, "Invalid map");
+
+    if ((section < 0) || (Column_NumOfValues <= section)) {
+        return QVariant();
+    }
+
+    return Names[section];
+}
+
+QVariant MqttsnClientFilterTopicStatsModel::countersData(const Counters& counters, int column, int role)
+{
+    // The column is relative to the direction
+    switch (column) {
+        case 0: return counters.m_msgs;
+        case 1: return counters.m_bytes;
+        case 2:
+            if (role == SortRole) {
+                // Sorted by the number of acknowledged messages
+                return counters.m_qos[1] + counters.m_qos[2];
+            }
+
+            return QString("%1/%2/%3").arg(counters.m_qos[0]).arg(counters.m_qos[1]).arg(counters.m_qos[2]);
+
+        case 3:
+            if (role == SortRole) {
+                return counters.m_lastSeenMs;
+            }
+
+            if (counters.m_lastSeenMs == 0) {
+                return QString();
+            }
+
+            return QDateTime::fromMSecsSinceEpoch(counters.m_lastSeenMs).toString("hh:mm:ss.zzz");
+
+        default: break;
+    }
+
+    return QVariant();
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
@@ -0,0 +1,75 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "MqttsnClientFilter.h"
+
+#include <QtCore/QAbstractTableModel>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Read-only table model exposing the per topic traffic statistics of the
+// filter. The statistics entries are only appended until cleared, so the
+// periodic sync reports the new rows as insertions.
+class MqttsnClientFilterTopicStatsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    using Base = QAbstractTableModel;
+
+public:
+    enum Column
+    {
+        Column_Topic,
+        Column_TxMsgs,
+        Column_TxBytes,
+        Column_TxQos,
+        Column_TxLastSeen,
+        Column_RxMsgs,
+        Column_RxBytes,
+        Column_RxQos,
+        Column_RxLastSeen,
+        Column_NumOfValues
+    };
+
+    // Raw value used for sorting
+    static const int SortRole = Qt::UserRole;
+
+    explicit MqttsnClientFilterTopicStatsModel(MqttsnClientFilter& filter, QObject* parentObj = nullptr);
+    ~MqttsnClientFilterTopicStatsModel() noexcept;
+
+    void sync();
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    using Counters = MqttsnClientFilterTopicStats::Counters;
+
+    static QVariant countersData(const Counters& counters, int column, int role);
+
+    MqttsnClientFilter& m_filter;
+    int m_rows = 0;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
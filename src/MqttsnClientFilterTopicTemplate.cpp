@@ -0,0 +1,120 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterTopicTemplate.h"
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+MqttsnClientFilterTopicTemplate::MqttsnClientFilterTopicTemplate() = default;
+MqttsnClientFilterTopicTemplate::~MqttsnClientFilterTopicTemplate() noexcept = default;
+
+void MqttsnClientFilterTopicTemplate::compile(const QString& pattern)
+{
+    m_pattern = pattern;
+    m_topic = pattern.toStdString();
+    m_segments.clear();
+    m_hasPlaceholders = false;
+
+    int pos = 0;
+    QString literal;
+    while (pos < pattern.size()) {
+        auto openPos = pattern.indexOf('{', pos);
+        auto closePos = (openPos < 0) ? -1 : pattern.indexOf('}', openPos + 1);
+        if ((openPos < 0) || (closePos < 0)) {
+            literal.append(pattern.mid(pos));
+            break;
+        }
+
+        literal.append(pattern.mid(pos, openPos - pos));
+        pos = closePos + 1;
+
+        auto prop = pattern.mid(openPos + 1, closePos - openPos - 1);
+        if (prop.isEmpty()) {
+            literal.append("{}");
+            continue;
+        }
+
+        if (!literal.isEmpty()) {
+            m_segments.resize(m_segments.size() + 1U);
+            m_segments.back().m_literal = literal.toStdString();
+            literal.clear();
+        }
+
+        m_segments.resize(m_segments.size() + 1U);
+        m_segments.back().m_prop = prop;
+        m_hasPlaceholders = true;
+    }
+
+    if (!literal.isEmpty()) {
+        m_segments.resize(m_segments.size() + 1U);
+        m_segments.back().m_literal = literal.toStdString();
+    }
+}
+
+void MqttsnClientFilterTopicTemplate::render(const QVariantMap& props, std::string& out) const
+{
+    if (!m_hasPlaceholders) {
+        out.assign(m_topic);
+        return;
+    }
+
+    // The missing property is rendered as empty string
+    out.clear();
+    for (auto& seg : m_segments) {
+        if (seg.m_prop.isEmpty()) {
+            out.append(seg.m_literal);
+            continue;
+        }
+
+        auto var = props.value(seg.m_prop);
+        if (var.isValid()) {
+            appendValue(var, out);
+        }
+    }
+}
+
+void MqttsnClientFilterTopicTemplate::appendValue(const QVariant& var, std::string& out)
+{
+    auto type = var.userType();
+    if ((type == QMetaType::Int) || (type == QMetaType::LongLong)) {
+        out.append(std::to_string(var.toLongLong()));
+        return;
+    }
+
+    if ((type == QMetaType::UInt) || (type == QMetaType::ULongLong)) {
+        out.append(std::to_string(var.toULongLong()));
+        return;
+    }
+
+    auto str = var.toString();
+    auto* chars = str.constData();
+    auto len = str.size();
+    for (auto idx = 0; idx < len; ++idx) {
+        if (0x80 <= chars[idx].unicode()) {
+            out.append(str.toStdString());
+            return;
+        }
+    }
+
+    // ASCII values are appended without intermediate conversion
+    for (auto idx = 0; idx < len; ++idx) {
+        out.push_back(static_cast<char>(chars[idx].unicode()));
+    }
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
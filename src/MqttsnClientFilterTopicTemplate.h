@@ -0,0 +1,73 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+#include <string>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Publish topic with the "{name}" placeholders substituted by the values
+// of the message properties, such as "site/{device_id}/{msg_name}".
+// The pattern is split into segments once, the topic is rendered into
+// the caller's buffer to reuse its capacity.
+class MqttsnClientFilterTopicTemplate
+{
+public:
+    MqttsnClientFilterTopicTemplate();
+    ~MqttsnClientFilterTopicTemplate() noexcept;
+
+    void compile(const QString& pattern);
+
+    const QString& pattern() const
+    {
+        return m_pattern;
+    }
+
+    bool hasPlaceholders() const
+    {
+        return m_hasPlaceholders;
+    }
+
+    void render(const QVariantMap& props, std::string& out) const;
+
+private:
+    struct Segment
+    {
+        std::string m_literal;
+        QString m_prop; // empty for the literal segment
+    };
+
+    using SegmentsList = std::vector<Segment>;
+
+    static void appendValue(const QVariant& var, std::string& out);
+
+    QString m_pattern;
+    std::string m_topic;
+    SegmentsList m_segments;
+    bool m_hasPlaceholders = false;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+
@@ -0,0 +1,152 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MqttsnClientFilterTopicTrie.h"
+
+#include <algorithm>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+namespace
+{
+
+const std::string_view SingleLevelWildcard("+");
+const std::string_view MultiLevelWildcard("#");
+
+void eraseValue(std::vector<int>& values, int value)
+{
+    auto iter = std::find(values.begin(), values.end(), value);
+    if (iter != values.end()) {
+        values.erase(iter);
+    }
+}
+
+} // namespace
+
+MqttsnClientFilterTopicTrie::MqttsnClientFilterTopicTrie() :
+    m_root(std::make_unique<Node>())
+{
+}
+
+MqttsnClientFilterTopicTrie::~MqttsnClientFilterTopicTrie() noexcept = default;
+
+void MqttsnClientFilterTopicTrie::insert(const std::string& filter, int value)
+{
+    auto* node = m_root.get();
+    std::string_view rest(filter);
+    while (true) {
+        auto sepPos = rest.find('/');
+        auto level = rest.substr(0, sepPos);
+        if (level == MultiLevelWildcard) {
+            node->m_multiLevelValues.push_back(value);
+            return;
+        }
+
+        std::unique_ptr<Node>* child = nullptr;
+        if (level == SingleLevelWildcard) {
+            child = &node->m_singleLevel;
+        }
+        else {
+            auto iter = node->m_children.find(level);
+            if (iter == node->m_children.end()) {
+                iter = node->m_children.emplace(std::string(level), std::unique_ptr<Node>()).first;
+            }
+            child = &iter->second;
+        }
+
+        if (!(*child)) {
+            *child = std::make_unique<Node>();
+        }
+
+        node = child->get();
+        if (sepPos == std::string_view::npos) {
+            node->m_values.push_back(value);
+            return;
+        }
+
+        rest = rest.substr(sepPos + 1U);
+    }
+}
+
+void MqttsnClientFilterTopicTrie::remove(const std::string& filter, int value)
+{
+    removeInternal(*m_root, filter, value);
+}
+
+void MqttsnClientFilterTopicTrie::clear()
+{
+    m_root = std::make_unique<Node>();
+}
+
+bool MqttsnClientFilterTopicTrie::removeInternal(Node& node, std::string_view filter, int value)
+{
+    auto sepPos = filter.find('/');
+    auto level = filter.substr(0, sepPos);
+    if (level == MultiLevelWildcard) {
+        eraseValue(node.m_multiLevelValues, value);
+        return isEmpty(node);
+    }
+
+    std::unique_ptr<Node>* child = nullptr;
+    auto iter = node.m_children.end();
+    if (level == SingleLevelWildcard) {
+        child = &node.m_singleLevel;
+    }
+    else {
+        iter = node.m_children.find(level);
+        if (iter != node.m_children.end()) {
+            child = &iter->second;
+        }
+    }
+
+    if ((child == nullptr) || (!(*child))) {
+        return isEmpty(node);
+    }
+
+    bool childEmpty = false;
+    if (sepPos == std::string_view::npos) {
+        eraseValue((*child)->m_values, value);
+        childEmpty = isEmpty(**child);
+    }
+    else {
+        childEmpty = removeInternal(**child, filter.substr(sepPos + 1U), value);
+    }
+
+    // Prune the branches not leading to any filter
+    if (childEmpty) {
+        if (iter != node.m_children.end()) {
+            node.m_children.erase(iter);
+        }
+        else {
+            child->reset();
+        }
+    }
+
+    return isEmpty(node);
+}
+
+bool MqttsnClientFilterTopicTrie::isEmpty(const Node& node)
+{
+    return
+        node.m_children.empty() &&
+        (!node.m_singleLevel) &&
+        node.m_values.empty() &&
+        node.m_multiLevelValues.empty();
+}
+
+}  // namespace cc_plugin_mqttsn_client_filter
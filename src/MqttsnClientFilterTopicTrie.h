@@ -0,0 +1,111 @@
+//
+// Copyright 2024 - 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cc_plugin_mqttsn_client_filter
+{
+
+// Trie of the MQTT topic filters split by levels. Every node holds the
+// values of the filters ending at it, so all the filters matching the
+// topic are found in a single walk over its levels.
+class MqttsnClientFilterTopicTrie
+{
+public:
+    MqttsnClientFilterTopicTrie();
+    ~MqttsnClientFilterTopicTrie() noexcept;
+
+    void insert(const std::string& filter, int value);
+    void remove(const std::string& filter, int value);
+    void clear();
+
+    template <typename TFunc>
+    void forEachMatch(std::string_view topic, TFunc&& func) const
+    {
+        // Wildcards on the first level don't match the topics starting with '$'
+        bool sysTopic = (!topic.empty()) && (topic[0] == '$');
+        matchLevel(*m_root, topic, sysTopic, func);
+    }
+
+private:
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> m_children;
+        std::unique_ptr<Node> m_singleLevel;
+        std::vector<int> m_values;
+        std::vector<int> m_multiLevelValues;
+    };
+
+    template <typename TFunc>
+    static void matchLevel(const Node& node, std::string_view topic, bool noWildcards, TFunc& func)
+    {
+        if (!noWildcards) {
+            for (auto v : node.m_multiLevelValues) {
+                func(v);
+            }
+        }
+
+        auto sepPos = topic.find('/');
+        auto level = topic.substr(0, sepPos);
+        auto rest = (sepPos == std::string_view::npos) ? std::string_view() : topic.substr(sepPos + 1U);
+        bool last = (sepPos == std::string_view::npos);
+
+        auto visit =
+            [&func, &rest, last](const Node& child)
+            {
+                if (last) {
+                    for (auto v : child.m_values) {
+                        func(v);
+                    }
+
+                    // "some/#" also matches "some"
+                    for (auto v : child.m_multiLevelValues) {
+                        func(v);
+                    }
+                    return;
+                }
+
+                matchLevel(child, rest, false, func);
+            };
+
+        auto iter = node.m_children.find(level);
+        if (iter != node.m_children.end()) {
+            visit(*iter->second);
+        }
+
+        if ((!noWildcards) && (node.m_singleLevel)) {
+            visit(*node.m_singleLevel);
+        }
+    }
+
+    static bool removeInternal(Node& node, std::string_view filter, int value);
+    static bool isEmpty(const Node& node);
+
+    std::unique_ptr<Node> m_root;
+};
+
+}  // namespace cc_plugin_mqttsn_client_filter
+
+